@@ -0,0 +1,58 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        BatchRenderer.cpp
+//
+// Author:      David Borland
+//
+// Description: Implementation of BatchRenderer class for MatchMaker.  Holds the glyph sets
+//              shared by all jobs and data transfers, so that each kind of glyph is drawn
+//              with one instanced mapper instead of an actor per job or sphere.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "BatchRenderer.h"
+
+#include "GeometryCache.h"
+
+
+BatchRenderer::BatchRenderer(vtkRenderer* ren, int resolution) {
+    // Unit cylinder along z, scaled per job.  Glyph sets are added in the same order the
+    // job actors were.
+    vtkAlgorithmOutput* cylinder = GeometryCache::GetOutputPort(GeometryCache::Cylinder, resolution);
+
+    for (int i = 0; i < NumJobGlyphs; i++) {
+        jobGlyphs[i] = new GlyphSet(cylinder, ren);
+    }
+
+    // Unit sphere, scaled per transfer sphere
+    transferSpheres = new GlyphSet(GeometryCache::GetOutputPort(GeometryCache::Sphere, 12), ren);
+}
+
+
+BatchRenderer::~BatchRenderer() {
+    for (int i = 0; i < NumJobGlyphs; i++) {
+        delete jobGlyphs[i];
+    }
+
+    delete transferSpheres;
+}
+
+
+GlyphSet* BatchRenderer::GetJobGlyphs(int type) {
+    return jobGlyphs[type];
+}
+
+
+GlyphSet* BatchRenderer::GetTransferSpheres() {
+    return transferSpheres;
+}
+
+
+void BatchRenderer::Update() {
+    for (int i = 0; i < NumJobGlyphs; i++) {
+        jobGlyphs[i]->Update();
+    }
+
+    transferSpheres->Update();
+}
\ No newline at end of file
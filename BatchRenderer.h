@@ -0,0 +1,53 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        BatchRenderer.h
+//
+// Author:      David Borland
+//
+// Description: Interface of BatchRenderer class for MatchMaker.  Holds the glyph sets shared
+//              by all jobs and data transfers, so that each kind of glyph is drawn with one
+//              instanced mapper instead of an actor per job or sphere.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef BATCHRENDERER_H
+#define BATCHRENDERER_H
+
+
+#include <vtkRenderer.h>
+
+#include "GlyphSet.h"
+
+
+class BatchRenderer {
+public:
+    // Kinds of job glyph
+    enum JobGlyphType {
+        Status,
+        GhostStatus,
+        OldGhostStatus,
+        Science,
+        GhostScience,
+        OldGhostScience,
+        NumJobGlyphs
+    };
+
+    BatchRenderer(vtkRenderer* ren, int resolution);
+    ~BatchRenderer();
+
+    GlyphSet* GetJobGlyphs(int type);
+
+    // Spheres for all data transfers
+    GlyphSet* GetTransferSpheres();
+
+    // Push any changes to the mappers.  Call once per frame.
+    void Update();
+
+private:
+    GlyphSet* jobGlyphs[NumJobGlyphs];
+    GlyphSet* transferSpheres;
+};
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,330 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        BinaryEvent.cpp
+//
+// Author:      David Borland
+//
+// Description: Implementation of the binary event format for MatchMaker.  Each record is a
+//              one-byte opcode followed by fixed-width fields.  IDs and names are interned:
+//              a string record gives a string its number the first time it is used, and
+//              after that only the number is written.  Numbers are little-endian.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "BinaryEvent.h"
+
+#include <string.h>
+
+
+static const char magic[4] = { 'M', 'M', 'E', 'V' };
+
+
+bool BinaryEvent::IsBinary(const char* data, size_t size) {
+    if (size < HeaderSize || memcmp(data, magic, sizeof(magic)) != 0) return false;
+
+    return ReadUInt(data + 4) == Version;
+}
+
+
+size_t BinaryEvent::RecordSize(const char* data, size_t size) {
+    if (size < 1) return 0;
+
+    // Size of the fields after the opcode
+    size_t fieldSize;
+
+    switch ((unsigned char)data[0]) {
+        case OpString:
+            if (size < 7) return 0;
+            fieldSize = 6 + ((unsigned char)data[5] | ((unsigned char)data[6] << 8));
+            break;
+
+        case OpTimestamp:           fieldSize = 8;  break;
+        case OpJobState:            fieldSize = 12; break;
+        case OpJobToSite:           fieldSize = 8;  break;
+        case OpJobWorkflow:         fieldSize = 8;  break;
+        case OpJobName:             fieldSize = 8;  break;
+        case OpJobDataSource:       fieldSize = 20; break;
+        case OpSiteRank:            fieldSize = 12; break;
+        case OpSiteLongLat:         fieldSize = 20; break;
+        case OpWorkflow:            fieldSize = 12; break;
+        case OpNetworkBandwidth:    fieldSize = 16; break;
+        case OpEndOfFile:           fieldSize = 0;  break;
+
+        default:
+            return 0;
+    }
+
+    return 1 + fieldSize <= size ? 1 + fieldSize : 0;
+}
+
+
+size_t BinaryEvent::EventSize(const char* data, size_t size, bool& hasTimestamp, double& timestamp) {
+    hasTimestamp = false;
+
+    size_t position = 0;
+
+    while (position < size) {
+        size_t recordSize = RecordSize(data + position, size - position);
+        if (recordSize == 0) return 0;
+
+        unsigned char opcode = (unsigned char)data[position];
+
+        if (opcode == OpTimestamp) {
+            hasTimestamp = true;
+            timestamp = ReadDouble(data + position + 1);
+        }
+
+        position += recordSize;
+
+        if (opcode != OpString && opcode != OpTimestamp) return position;
+    }
+
+    return 0;
+}
+
+
+unsigned int BinaryEvent::ReadUInt(const char* data) {
+    unsigned int value;
+    memcpy(&value, data, sizeof(value));
+
+    return value;
+}
+
+double BinaryEvent::ReadDouble(const char* data) {
+    double value;
+    memcpy(&value, data, sizeof(value));
+
+    return value;
+}
+
+
+BinaryEventWriter::BinaryEventWriter() {
+}
+
+BinaryEventWriter::~BinaryEventWriter() {
+}
+
+
+void BinaryEventWriter::WriteHeader(std::string& s) {
+    s.append(magic, sizeof(magic));
+    WriteUInt(BinaryEvent::Version, s);
+}
+
+
+void BinaryEventWriter::WriteStrings(const std::vector<std::string>& table, int count, std::string& s) {
+    // Interning in order gives each string its number from the table
+    for (int i = 0; i < count && i < (int)table.size(); i++) {
+        Intern(table[i], s);
+    }
+}
+
+
+void BinaryEventWriter::WriteTimestamp(double timestamp, std::string& s) {
+    WriteOpcode(BinaryEvent::OpTimestamp, s);
+    WriteDouble(timestamp, s);
+}
+
+void BinaryEventWriter::WriteJobState(const std::string& jobID, const std::string& state, const std::string* science, std::string& s) {
+    // Intern first, so string records come before the event
+    unsigned int job = Intern(jobID, s);
+    unsigned int stateString = Intern(state, s);
+    unsigned int scienceString = science ? Intern(*science, s) : BinaryEvent::NoString;
+
+    WriteOpcode(BinaryEvent::OpJobState, s);
+    WriteUInt(job, s);
+    WriteUInt(stateString, s);
+    WriteUInt(scienceString, s);
+}
+
+void BinaryEventWriter::WriteJobToSite(const std::string& jobID, const std::string& siteID, std::string& s) {
+    unsigned int job = Intern(jobID, s);
+    unsigned int site = Intern(siteID, s);
+
+    WriteOpcode(BinaryEvent::OpJobToSite, s);
+    WriteUInt(job, s);
+    WriteUInt(site, s);
+}
+
+void BinaryEventWriter::WriteJobWorkflow(const std::string& jobID, const std::string& workflowID, std::string& s) {
+    unsigned int job = Intern(jobID, s);
+    unsigned int workflow = Intern(workflowID, s);
+
+    WriteOpcode(BinaryEvent::OpJobWorkflow, s);
+    WriteUInt(job, s);
+    WriteUInt(workflow, s);
+}
+
+void BinaryEventWriter::WriteJobName(const std::string& jobID, const std::string& jobName, std::string& s) {
+    unsigned int job = Intern(jobID, s);
+    unsigned int name = Intern(jobName, s);
+
+    WriteOpcode(BinaryEvent::OpJobName, s);
+    WriteUInt(job, s);
+    WriteUInt(name, s);
+}
+
+void BinaryEventWriter::WriteJobDataSource(const std::string& jobID, const std::string& sourceID, const std::string& sinkID, double dataSize, std::string& s) {
+    unsigned int job = Intern(jobID, s);
+    unsigned int source = Intern(sourceID, s);
+    unsigned int sink = Intern(sinkID, s);
+
+    WriteOpcode(BinaryEvent::OpJobDataSource, s);
+    WriteUInt(job, s);
+    WriteUInt(source, s);
+    WriteUInt(sink, s);
+    WriteDouble(dataSize, s);
+}
+
+void BinaryEventWriter::WriteSiteRank(const std::string& siteID, double rank, std::string& s) {
+    unsigned int site = Intern(siteID, s);
+
+    WriteOpcode(BinaryEvent::OpSiteRank, s);
+    WriteUInt(site, s);
+    WriteDouble(rank, s);
+}
+
+void BinaryEventWriter::WriteSiteLongLat(const std::string& siteID, double longitude, double latitude, std::string& s) {
+    unsigned int site = Intern(siteID, s);
+
+    WriteOpcode(BinaryEvent::OpSiteLongLat, s);
+    WriteUInt(site, s);
+    WriteDouble(longitude, s);
+    WriteDouble(latitude, s);
+}
+
+void BinaryEventWriter::WriteWorkflow(const std::string& workflowID, const std::string& username, const std::string& workflowName, std::string& s) {
+    unsigned int workflow = Intern(workflowID, s);
+    unsigned int user = Intern(username, s);
+    unsigned int name = Intern(workflowName, s);
+
+    WriteOpcode(BinaryEvent::OpWorkflow, s);
+    WriteUInt(workflow, s);
+    WriteUInt(user, s);
+    WriteUInt(name, s);
+}
+
+void BinaryEventWriter::WriteNetworkBandwidth(const std::string& sourceID, const std::string& destID, double bandwidth, std::string& s) {
+    unsigned int source = Intern(sourceID, s);
+    unsigned int dest = Intern(destID, s);
+
+    WriteOpcode(BinaryEvent::OpNetworkBandwidth, s);
+    WriteUInt(source, s);
+    WriteUInt(dest, s);
+    WriteDouble(bandwidth, s);
+}
+
+void BinaryEventWriter::WriteEndOfFile(std::string& s) {
+    WriteOpcode(BinaryEvent::OpEndOfFile, s);
+
+    ClearStrings();
+}
+
+
+bool BinaryEventWriter::WriteLine(const Tokenizer& tokens, std::string& s) {
+    int numTokens = tokens.GetNumTokens();
+
+    if (tokens.TooManyTokens()) return false;
+
+    if (numTokens == 1 && tokens[0] == "EOF") {
+        WriteEndOfFile(s);
+        return true;
+    }
+
+    std::string& t1 = lineStrings[0];
+    std::string& t3 = lineStrings[1];
+    std::string& t5 = lineStrings[2];
+    if (numTokens > 1) tokens[1].CopyTo(t1);
+    if (numTokens > 3) tokens[3].CopyTo(t3);
+    if (numTokens > 5) tokens[5].CopyTo(t5);
+
+    if (tokens[0] == "job" && (numTokens == 4 || numTokens == 6 || numTokens == 10)) {
+        const Token& command = tokens[2];
+
+        if (command == "state" && numTokens != 10) {
+            bool hasScience = numTokens == 6 && tokens[4] == "science";
+
+            WriteJobState(t1, t3, hasScience ? &t5 : NULL, s);
+        }
+        else if (command == "tosite" && numTokens == 4) {
+            WriteJobToSite(t1, t3, s);
+        }
+        else if (command == "workflow" && numTokens == 4) {
+            WriteJobWorkflow(t1, t3, s);
+        }
+        else if (command == "job_name" && numTokens == 4) {
+            WriteJobName(t1, t3, s);
+        }
+        else if (command == "data_source" && numTokens == 10) {
+            WriteJobDataSource(t1, t3, t5, tokens[7].ToDouble(), s);
+        }
+        else {
+            return false;
+        }
+    }
+    else if (tokens[0] == "site" && numTokens == 4 && tokens[2] == "rank") {
+        WriteSiteRank(t1, tokens[3].ToDouble(), s);
+    }
+    else if (tokens[0] == "site" && numTokens == 5 && tokens[2] == "longlat") {
+        WriteSiteLongLat(t1, tokens[3].ToDouble(), tokens[4].ToDouble(), s);
+    }
+    else if (tokens[0] == "workflow" && numTokens == 6) {
+        WriteWorkflow(t1, t3, t5, s);
+    }
+    else if (tokens[0] == "network_bandwidth" && numTokens == 6) {
+        std::string& t2 = lineStrings[0];
+        std::string& t4 = lineStrings[1];
+        tokens[2].CopyTo(t2);
+        tokens[4].CopyTo(t4);
+
+        WriteNetworkBandwidth(t2, t4, tokens[5].ToDouble(), s);
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+
+int BinaryEventWriter::GetNumStrings() {
+    return (int)strings.size();
+}
+
+void BinaryEventWriter::ClearStrings() {
+    strings.clear();
+}
+
+
+unsigned int BinaryEventWriter::Intern(const std::string& value, std::string& s) {
+    std::unordered_map<std::string, unsigned int>::iterator it = strings.find(value);
+    if (it != strings.end()) return it->second;
+
+    unsigned int id = (unsigned int)strings.size();
+    strings[value] = id;
+
+    // Protocol strings are short, but the length only has 2 bytes
+    size_t length = value.size() < 0xFFFF ? value.size() : 0xFFFF;
+
+    WriteOpcode(BinaryEvent::OpString, s);
+    WriteUInt(id, s);
+    s += (char)(length & 0xFF);
+    s += (char)(length >> 8);
+    s.append(value, 0, length);
+
+    return id;
+}
+
+
+void BinaryEventWriter::WriteOpcode(BinaryEvent::Opcode opcode, std::string& s) {
+    s += (char)opcode;
+}
+
+void BinaryEventWriter::WriteUInt(unsigned int value, std::string& s) {
+    // MatchMaker only runs on little-endian hosts, so the bytes are written as is
+    s.append((const char*)&value, sizeof(value));
+}
+
+void BinaryEventWriter::WriteDouble(double value, std::string& s) {
+    s.append((const char*)&value, sizeof(value));
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        BinaryEvent.h
+//
+// Author:      David Borland
+//
+// Description: Interface of the binary event format for MatchMaker.  Each record is a
+//              one-byte opcode followed by fixed-width fields.  IDs and names are interned:
+//              a string record gives a string its number the first time it is used, and
+//              after that only the number is written.  Numbers are little-endian.
+//
+//              A file starts with the four bytes "MMEV" and a four-byte version.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef BINARYEVENT_H
+#define BINARYEVENT_H
+
+
+#include <stddef.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Tokenizer.h"
+
+
+class BinaryEvent {
+public:
+    enum Opcode {
+        OpString = 1,           // id, length (2 bytes), characters
+        OpTimestamp,            // seconds (8 bytes), applies to the next event
+        OpJobState,             // job, state, science or NoString
+        OpJobToSite,            // job, site
+        OpJobWorkflow,          // job, workflow
+        OpJobName,              // job, name
+        OpJobDataSource,        // job, source site, sink site, size (8 bytes)
+        OpSiteRank,             // site, rank (8 bytes)
+        OpSiteLongLat,          // site, longitude (8 bytes), latitude (8 bytes)
+        OpWorkflow,             // workflow, username, name
+        OpNetworkBandwidth,     // source site, dest site, bandwidth (8 bytes)
+        OpEndOfFile
+    };
+
+    // Strings are numbered with 4 bytes
+    enum { NoString = 0xFFFFFFFF };
+
+    enum { Version = 1 };
+    enum { HeaderSize = 8 };
+
+    // Check the header at the start of a file
+    static bool IsBinary(const char* data, size_t size);
+
+    // Size of the record at data, or 0 if it is invalid or runs past size
+    static size_t RecordSize(const char* data, size_t size);
+
+    // Size of the string and timestamp records at data plus the event record they come
+    // before, or 0 if there isn't a complete event.  These are always kept together.
+    static size_t EventSize(const char* data, size_t size, bool& hasTimestamp, double& timestamp);
+
+    // Read fields.  The caller checks the size first.
+    static unsigned int ReadUInt(const char* data);
+    static double ReadDouble(const char* data);
+};
+
+
+class BinaryEventWriter {
+public:
+    BinaryEventWriter();
+    ~BinaryEventWriter();
+
+    void WriteHeader(std::string& s);
+
+    // Write the first count strings of a file's string table, with the same numbers.  Must
+    // be called before anything else is written.
+    void WriteStrings(const std::vector<std::string>& table, int count, std::string& s);
+
+    void WriteTimestamp(double timestamp, std::string& s);
+    void WriteJobState(const std::string& jobID, const std::string& state, const std::string* science, std::string& s);
+    void WriteJobToSite(const std::string& jobID, const std::string& siteID, std::string& s);
+    void WriteJobWorkflow(const std::string& jobID, const std::string& workflowID, std::string& s);
+    void WriteJobName(const std::string& jobID, const std::string& jobName, std::string& s);
+    void WriteJobDataSource(const std::string& jobID, const std::string& sourceID, const std::string& sinkID, double dataSize, std::string& s);
+    void WriteSiteRank(const std::string& siteID, double rank, std::string& s);
+    void WriteSiteLongLat(const std::string& siteID, double longitude, double latitude, std::string& s);
+    void WriteWorkflow(const std::string& workflowID, const std::string& username, const std::string& workflowName, std::string& s);
+    void WriteNetworkBandwidth(const std::string& sourceID, const std::string& destID, double bandwidth, std::string& s);
+    void WriteEndOfFile(std::string& s);
+
+    // Write the event on a line of text data, returning false if the line isn't a valid
+    // event.  Nothing is written for an invalid line.  Timestamps aren't written.
+    bool WriteLine(const Tokenizer& tokens, std::string& s);
+
+    // Forget the strings written so far, so they are written again the next time they are
+    // used.  The end of file record also does this, as readers forget their strings there.
+    int GetNumStrings();
+    void ClearStrings();
+
+private:
+    // Numbers of the strings written so far
+    std::unordered_map<std::string, unsigned int> strings;
+
+    // Scratch strings for WriteLine
+    std::string lineStrings[3];
+
+    // Write a string record if this string is new, and return its number
+    unsigned int Intern(const std::string& value, std::string& s);
+
+    void WriteOpcode(BinaryEvent::Opcode opcode, std::string& s);
+    void WriteUInt(unsigned int value, std::string& s);
+    void WriteDouble(double value, std::string& s);
+};
+
+
+#endif
\ No newline at end of file
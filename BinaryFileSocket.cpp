@@ -0,0 +1,141 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        BinaryFileSocket.cpp
+//
+// Author:      David Borland
+//
+// Description: Implementation of BinaryFileSocket class for reading binary event data from
+//              a file as if it were a socket.  Works like TextFileSocket, but each event 
+//              record, along with any string and timestamp records before it, takes the 
+//              place of a line.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "BinaryFileSocket.h"
+
+#include "BinaryEvent.h"
+
+#include <wx/log.h>
+
+#include <stdio.h>
+
+
+BinaryFileSocket::BinaryFileSocket(bool readAllData, int numEventsPerRead, double speed, int numSnapshotEvents)
+: TextFileSocket(readAllData, numEventsPerRead, speed, numSnapshotEvents) {
+}
+
+
+BinaryFileSocket::~BinaryFileSocket() {
+}
+
+
+bool BinaryFileSocket::IsBinaryFile(const char* fileName) {
+    FILE* f = fopen(fileName, "rb");
+    if (!f) return false;
+
+    char header[BinaryEvent::HeaderSize];
+    size_t size = fread(header, 1, sizeof(header), f);
+    fclose(f);
+
+    return BinaryEvent::IsBinary(header, size);
+}
+
+
+bool BinaryFileSocket::Open(const char* fileName) {
+    eventStarts.clear();
+    timestamps.clear();
+    hasTimestamps.clear();
+    strings.clear();
+    stringCounts.clear();
+
+    // No line index for binary data
+    if (!file.Open(fileName, false)) return false;
+
+    const char* data = file.GetData();
+    size_t size = file.GetSize();
+
+    if (!BinaryEvent::IsBinary(data, size)) {
+        wxLogMessage("%s is not a binary event file", fileName);
+        file.Close();
+        return false;
+    }
+
+    // Index the events
+    size_t position = BinaryEvent::HeaderSize;
+
+    while (position < size) {
+        bool hasTimestamp;
+        double timestamp = 0.0;
+        size_t eventSize = BinaryEvent::EventSize(data + position, size - position, hasTimestamp, timestamp);
+
+        if (eventSize == 0) {
+            wxLogMessage("Ignoring invalid data at the end of %s", fileName);
+            break;
+        }
+
+        eventStarts.push_back(position);
+        timestamps.push_back(timestamp);
+        hasTimestamps.push_back(hasTimestamp);
+        stringCounts.push_back((int)strings.size());
+
+        // Collect the strings, which come before the event record, mixed in with the timestamp
+        size_t end = position + eventSize;
+        while (position < end) {
+            size_t recordSize = BinaryEvent::RecordSize(data + position, end - position);
+
+            if (data[position] == BinaryEvent::OpString) {
+                unsigned int id = BinaryEvent::ReadUInt(data + position + 1);
+
+                if (id >= strings.size()) strings.resize(id + 1);
+                strings[id].assign(data + position + 7, recordSize - 7);
+            }
+
+            position += recordSize;
+        }
+    }
+
+    eventStarts.push_back(position);
+    stringCounts.push_back((int)strings.size());
+
+    return true;
+}
+
+
+int BinaryFileSocket::GetNumLines() {
+    return (int)eventStarts.size() - 1;
+}
+
+
+void BinaryFileSocket::CopyLines(int first, int last, std::string& s) {
+    s.assign(file.GetData() + eventStarts[first], eventStarts[last] - eventStarts[first]);
+}
+
+
+bool BinaryFileSocket::GetTimestamp(int line, double& timestamp) {
+    if (!hasTimestamps[line]) return false;
+
+    timestamp = timestamps[line];
+
+    return true;
+}
+
+
+void BinaryFileSocket::EndOfFile(std::string& s) {
+    s.assign(1, (char)BinaryEvent::OpEndOfFile);
+}
+
+
+void BinaryFileSocket::FoldLines(int first, int last) {
+    replayState.ParseBinary(file.GetData() + eventStarts[first], eventStarts[last] - eventStarts[first], strings);
+}
+
+
+void BinaryFileSocket::WriteState(int line, std::string& s) {
+    // The parser's strings are gone after a reset, so send every string defined before this
+    // event, keeping the file's numbering for the events that follow
+    BinaryEventWriter writer;
+    writer.WriteStrings(strings, stringCounts[line], s);
+
+    replayState.WriteBinary(writer, s);
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        BinaryFileSocket.h
+//
+// Author:      David Borland
+//
+// Description: Interface of BinaryFileSocket class for reading binary event data from a 
+//              file as if it were a socket.  Works like TextFileSocket, but each event 
+//              record, along with any string and timestamp records before it, takes the 
+//              place of a line.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef BINARYFILESOCKET_H
+#define BINARYFILESOCKET_H
+
+
+#include "TextFileSocket.h"
+
+#include <vector>
+
+
+class BinaryFileSocket : public TextFileSocket {
+public:
+    BinaryFileSocket(bool readAllData = false, int numEventsPerRead = 1, double speed = 1.0, int numSnapshotEvents = 10000);
+    virtual ~BinaryFileSocket();
+
+    // Check whether a file holds binary event data
+    static bool IsBinaryFile(const char* fileName);
+
+protected:
+    virtual bool Open(const char* fileName);
+
+    virtual int GetNumLines();
+    virtual void CopyLines(int first, int last, std::string& s);
+    virtual bool GetTimestamp(int line, double& timestamp);
+    virtual void EndOfFile(std::string& s);
+
+    virtual void FoldLines(int first, int last);
+    virtual void WriteState(int line, std::string& s);
+
+private:
+    // Offset of the start of each event, plus the end of the last event
+    std::vector<size_t> eventStarts;
+
+    std::vector<double> timestamps;
+    std::vector<bool> hasTimestamps;
+
+    // Every string in the file, by number, and the number of strings before each event
+    std::vector<std::string> strings;
+    std::vector<int> stringCounts;
+};
+
+
+#endif
\ No newline at end of file
@@ -32,6 +32,9 @@ ConfigFileParser::ConfigFileParser() {
 
     socketReadAll = true;
     socketReadInterval = 100;
+    socketLinesPerRead = 1;
+    replaySpeed = 1.0;
+    snapshotLines = 10000;
     bool loopFile = true;
 
     graphicsUpdateInterval = 10;
@@ -54,8 +57,13 @@ ConfigFileParser::ConfigFileParser() {
     fadeGhostJobs = true;
     showJobPaths = true;
     showSiteSpindles = true;
+    instancedJobGlyphs = false;
+    lodDistance = 0.0;
 
     useDoneSite = true;
+    retainDoneJobs = 0;
+    retainDoneSeconds = 0.0;
+    rememberRetiredJobs = 100000;
 
     fadedOpacity = 0.25;
 
@@ -226,6 +234,18 @@ bool ConfigFileParser::Parse(const std::string& fileName) {
                 socketReadInterval = atoi(tokens[1].c_str());
                 wxLogMessage("socketReadInterval = %d", socketReadInterval);
             }
+            else if (tokens[0] == "SocketLinesPerRead") {
+                socketLinesPerRead = atoi(tokens[1].c_str());
+                wxLogMessage("socketLinesPerRead = %d", socketLinesPerRead);
+            }
+            else if (tokens[0] == "ReplaySpeed") {
+                replaySpeed = atof(tokens[1].c_str());
+                wxLogMessage("replaySpeed = %f", replaySpeed);
+            }
+            else if (tokens[0] == "SnapshotLines") {
+                snapshotLines = atoi(tokens[1].c_str());
+                wxLogMessage("snapshotLines = %d", snapshotLines);
+            }
             else if (tokens[0] == "LoopFile") {
                 loopFile = atoi(tokens[1].c_str()) != 0;
                 wxLogMessage("loopFile = %d", loopFile);
@@ -305,10 +325,30 @@ bool ConfigFileParser::Parse(const std::string& fileName) {
                 showSiteSpindles = atoi(tokens[1].c_str()) != 0;
                 wxLogMessage("showSiteSpindles = %d", showSiteSpindles);
             }   
+            else if (tokens[0] == "InstancedJobGlyphs") {
+                instancedJobGlyphs = atoi(tokens[1].c_str()) != 0;
+                wxLogMessage("instancedJobGlyphs = %d", instancedJobGlyphs);
+            }
+            else if (tokens[0] == "LODDistance") {
+                lodDistance = atof(tokens[1].c_str());
+                wxLogMessage("lodDistance = %f", lodDistance);
+            }
             else if (tokens[0] == "UseDoneSite") {
                 useDoneSite = atoi(tokens[1].c_str()) != 0;
                 wxLogMessage("useDoneSite = %d", useDoneSite);
             } 
+            else if (tokens[0] == "RetainDoneJobs") {
+                retainDoneJobs = atoi(tokens[1].c_str());
+                wxLogMessage("retainDoneJobs = %d", retainDoneJobs);
+            }
+            else if (tokens[0] == "RetainDoneSeconds") {
+                retainDoneSeconds = atof(tokens[1].c_str());
+                wxLogMessage("retainDoneSeconds = %f", retainDoneSeconds);
+            }
+            else if (tokens[0] == "RememberRetiredJobs") {
+                rememberRetiredJobs = atoi(tokens[1].c_str());
+                wxLogMessage("rememberRetiredJobs = %d", rememberRetiredJobs);
+            }
             else if (tokens[0] == "FadedOpacity") {
                 fadedOpacity = atof(tokens[1].c_str());
                 wxLogMessage("fadedOpacity = %f", fadedOpacity);
@@ -412,6 +452,18 @@ int ConfigFileParser::GetSocketReadInterval() {
     return socketReadInterval;
 }
 
+int ConfigFileParser::GetSocketLinesPerRead() {
+    return socketLinesPerRead;
+}
+
+double ConfigFileParser::GetReplaySpeed() {
+    return replaySpeed;
+}
+
+int ConfigFileParser::GetSnapshotLines() {
+    return snapshotLines;
+}
+
 bool ConfigFileParser::LoopFile() {
     return loopFile;
 }
@@ -486,11 +538,31 @@ bool ConfigFileParser::ShowSiteSpindles() {
     return showSiteSpindles;
 }
 
+bool ConfigFileParser::InstancedJobGlyphs() {
+    return instancedJobGlyphs;
+}
+
+double ConfigFileParser::GetLODDistance() {
+    return lodDistance;
+}
+
 
 bool ConfigFileParser::UseDoneSite() {
     return useDoneSite;
 }
 
+int ConfigFileParser::GetRetainDoneJobs() {
+    return retainDoneJobs;
+}
+
+double ConfigFileParser::GetRetainDoneSeconds() {
+    return retainDoneSeconds;
+}
+
+int ConfigFileParser::GetRememberRetiredJobs() {
+    return rememberRetiredJobs;
+}
+
 
 double ConfigFileParser::GetFadedOpacity() {
     return fadedOpacity;
@@ -43,6 +43,9 @@ public:
 
     bool GetSocketReadAll();
     int GetSocketReadInterval();
+    int GetSocketLinesPerRead();
+    double GetReplaySpeed();
+    int GetSnapshotLines();
     bool LoopFile();
 
     int GetGraphicsUpdateInterval();
@@ -66,8 +69,13 @@ public:
     bool ShowJobPaths();
     bool ShowJobTrails();
     bool ShowSiteSpindles();
+    bool InstancedJobGlyphs();
+    double GetLODDistance();
 
     bool UseDoneSite();
+    int GetRetainDoneJobs();
+    double GetRetainDoneSeconds();
+    int GetRememberRetiredJobs();
 
     double GetFadedOpacity();
 
@@ -100,6 +108,9 @@ private:
 
     bool socketReadAll;
     int socketReadInterval;
+    int socketLinesPerRead;
+    double replaySpeed;
+    int snapshotLines;
     bool loopFile;
 
     int graphicsUpdateInterval;
@@ -123,8 +134,13 @@ private:
     bool showJobPaths;
     bool showJobTrails;
     bool showSiteSpindles;
+    bool instancedJobGlyphs;
+    double lodDistance;
 
     bool useDoneSite;
+    int retainDoneJobs;
+    double retainDoneSeconds;
+    int rememberRetiredJobs;
 
     double fadedOpacity;
 
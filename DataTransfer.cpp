@@ -11,22 +11,20 @@
 
 #include "DataTransfer.h"
 
+#include "GeometryCache.h"
+
 #include <vtkMath.h>
 #include <vtkProperty.h>
 
-#include <wx/log.h>
-
+#include <math.h>
 
-DataTransfer::DataTransfer(Site* sourceSite, Site* sinkSite, NetworkConnection* connection, Job* requester, double dataSize, vtkRenderer* ren) 
-: source(sourceSite), job(requester), size(dataSize), renderer(ren) {
-    // Create the sphere and mapper used for all spheres
-    sphere = vtkSphereSource::New();
-    sphere->SetRadius(1.0);
-    sphere->SetThetaResolution(12);
+#include <wx/log.h>
 
-    mapper = vtkPolyDataMapper::New();
-    mapper->SetInputConnection(sphere->GetOutputPort());
 
+DataTransfer::DataTransfer(Site* sourceSite, Site* sinkSite, NetworkConnection* connection, Job* requester, double dataSize, vtkRenderer* ren,
+                           BatchRenderer* batchRenderer) 
+: source(sourceSite), job(requester), size(dataSize), renderer(ren), batch(batchRenderer) {
+    opacity = 1.0;
 
     // Get the position pointers set up correctly
     if (source->GetID() == connection->GetSourceID() && sinkSite->GetID() == connection->GetDestID()) {
@@ -44,24 +42,15 @@ DataTransfer::DataTransfer(Site* sourceSite, Site* sinkSite, NetworkConnection*
 
 
     // Create the lines
-    fromSourceLine = vtkLineSource::New();
-    vtkPolyDataMapper* fromSourceLineMapper = vtkPolyDataMapper::New();
-    fromSourceLineMapper->SetInputConnection(fromSourceLine->GetOutputPort());
     fromSourceLineActor = vtkActor::New();
-    fromSourceLineActor->SetMapper(fromSourceLineMapper);
+    fromSourceLineActor->SetMapper(GeometryCache::GetMapper(GeometryCache::Line, 1));
 
-    toJobLine = vtkLineSource::New();
-    vtkPolyDataMapper* toJobLineMapper = vtkPolyDataMapper::New();
-    toJobLineMapper->SetInputConnection(toJobLine->GetOutputPort());
     toJobLineActor = vtkActor::New();
-    toJobLineActor->SetMapper(toJobLineMapper);
+    toJobLineActor->SetMapper(GeometryCache::GetMapper(GeometryCache::Line, 1));
 
     renderer->AddViewProp(fromSourceLineActor);
     renderer->AddViewProp(toJobLineActor);
 
-    fromSourceLineMapper->Delete();
-    toJobLineMapper->Delete();
-
 
     // Set the initial animation offset
     offset = 0.0;
@@ -74,19 +63,13 @@ DataTransfer::DataTransfer(Site* sourceSite, Site* sinkSite, NetworkConnection*
 
 DataTransfer::~DataTransfer() {
     // Clean up
-    renderer->RemoveViewProp(atJob);
-    atJob->Delete();
-
-    sphere->Delete();
-    mapper->Delete();
+    DeleteSphere(atJob);
 
     for (int i = 0; i < (int)fromSource.size(); i++) {
-        renderer->RemoveViewProp(fromSource[i]);
-        fromSource[i]->Delete();
+        DeleteSphere(fromSource[i]);
     }
     for (int i = 0; i < (int)toJob.size(); i++) {
-        renderer->RemoveViewProp(toJob[i]);
-        toJob[i]->Delete();
+        DeleteSphere(toJob[i]);
     }
 
     renderer->RemoveViewProp(fromSourceLineActor);
@@ -99,19 +82,21 @@ DataTransfer::~DataTransfer() {
 void DataTransfer::SetOpacity(double sphereOpacity) {
     opacity = sphereOpacity;
     for (int i = 0; i < (int)fromSource.size(); i++) {
-        fromSource[i]->GetProperty()->SetOpacity(opacity);
+        SetSphereOpacity(fromSource[i], opacity);
     }    
     for (int i = 0; i < (int)toJob.size(); i++) {
-        toJob[i]->GetProperty()->SetOpacity(opacity);
+        SetSphereOpacity(toJob[i], opacity);
     }
-    atJob->GetProperty()->SetOpacity(opacity);
+    SetSphereOpacity(atJob, opacity);
 
     fromSourceLineActor->GetProperty()->SetOpacity(opacity);
     toJobLineActor->GetProperty()->SetOpacity(opacity);
 }
 
 
-void DataTransfer::Update() {
+bool DataTransfer::Update(int numSteps) {
+    if (numSteps <= 0) return false;
+
     // Spacing between spheres
     double radius = job->GetRadius() * radiusScale * size * 0.1;
     radius = radius < job->GetRadius() * radiusScale ? job->GetRadius() * radiusScale : radius;
@@ -154,64 +139,122 @@ void DataTransfer::Update() {
     // Do the update
     DoUpdate(fromSource, startPoint, midPoint, radius, spacing);
     DoUpdate(toJob, midPoint, endPoint, radius, spacing);
-    atJob->SetPosition(endPoint.X(), endPoint.Y(), endPoint.Z());
-    atJob->SetScale(radius, radius, job->GetHeight() * 0.5);
+    SetSpherePosition(atJob, endPoint);
+    SetSphereScale(atJob, radius, radius, job->GetHeight() * 0.5);
 
-    fromSourceLine->SetPoint1(startPoint.X(), startPoint.Y(), startPoint.Z() + 0.1);
-    fromSourceLine->SetPoint2(midPoint.X(), midPoint.Y(), midPoint.Z() + 0.1);
-    toJobLine->SetPoint1(midPoint.X(), midPoint.Y(), midPoint.Z() + 0.1);
-    toJobLine->SetPoint2(endPoint.X(), endPoint.Y(), endPoint.Z() + 0.1);
+    Vec3 lineOffset(0.0, 0.0, 0.1);
+    GeometryCache::SetLine(fromSourceLineActor, startPoint + lineOffset, midPoint + lineOffset);
+    GeometryCache::SetLine(toJobLineActor, midPoint + lineOffset, endPoint + lineOffset);
 
     // Color
     DoColor();
 
     // Increment the animation
-    offset += offsetIncrement;
-    offset = offset > spacing ? 0.0 : offset;
+    offset += offsetIncrement * numSteps;
+    offset = offset > spacing ? fmod(offset, spacing) : offset;
+
+    return true;
+}
+
+
+DataTransfer::Sphere DataTransfer::CreateSphere() {
+    Sphere sphere;
+
+    if (batch) {
+        GlyphSet* spheres = batch->GetTransferSpheres();
+
+        sphere.actor = NULL;
+        sphere.row = spheres->AddRow();
+        spheres->SetVisible(sphere.row, true);
+    }
+    else {
+        sphere.actor = vtkActor::New();
+        sphere.actor->SetMapper(GeometryCache::GetMapper(GeometryCache::Sphere, 12));
+        sphere.row = -1;
+
+        renderer->AddViewProp(sphere.actor);
+    }
+
+    SetSphereColor(sphere, 0.0, 0.4, 0.0);
+    SetSphereOpacity(sphere, opacity);
+
+    return sphere;
+}
+
+void DataTransfer::DeleteSphere(const Sphere& sphere) {
+    if (batch) {
+        batch->GetTransferSpheres()->RemoveRow(sphere.row);
+    }
+    else {
+        renderer->RemoveViewProp(sphere.actor);
+        sphere.actor->Delete();
+    }
 }
 
 
-vtkActor* DataTransfer::CreateSphere() {
-    vtkActor* actor = vtkActor::New();
-    actor->SetMapper(mapper);
-    actor->GetProperty()->SetColor(0.0, 0.4, 0.0);
-    actor->GetProperty()->SetOpacity(opacity);
+void DataTransfer::SetSpherePosition(const Sphere& sphere, const Vec3& pos) {
+    if (batch) {
+        batch->GetTransferSpheres()->SetPosition(sphere.row, pos.X(), pos.Y(), pos.Z());
+    }
+    else {
+        sphere.actor->SetPosition(pos.X(), pos.Y(), pos.Z());
+    }
+}
+
+void DataTransfer::SetSphereScale(const Sphere& sphere, double x, double y, double z) {
+    if (batch) {
+        batch->GetTransferSpheres()->SetScale(sphere.row, x, y, z);
+    }
+    else {
+        sphere.actor->SetScale(x, y, z);
+    }
+}
 
-    renderer->AddViewProp(actor);
+void DataTransfer::SetSphereColor(const Sphere& sphere, double r, double g, double b) {
+    if (batch) {
+        batch->GetTransferSpheres()->SetColor(sphere.row, r, g, b);
+    }
+    else {
+        sphere.actor->GetProperty()->SetColor(r, g, b);
+    }
+}
 
-    return actor;
+void DataTransfer::SetSphereOpacity(const Sphere& sphere, double sphereOpacity) {
+    if (batch) {
+        batch->GetTransferSpheres()->SetOpacity(sphere.row, sphereOpacity);
+    }
+    else {
+        sphere.actor->GetProperty()->SetOpacity(sphereOpacity);
+    }
 }
 
 
-void DataTransfer::DoUpdate(std::vector<vtkActor*>& actors, const Vec3& pos1, const Vec3& pos2, double radius, double spacing) {
+void DataTransfer::DoUpdate(std::vector<Sphere>& spheres, const Vec3& pos1, const Vec3& pos2, double radius, double spacing) {
     Vec3 vec = pos2 - pos1;
     double distance = vec.Magnitude();
     vec.Normalize();
 
     int numSpheres = distance / spacing;
 
-    if (numSpheres > (int)actors.size()) {
-        int diff = numSpheres - (int)actors.size();
+    // Rows freed here are reused by the next sphere created, so the glyph arrays don't grow
+    if (numSpheres > (int)spheres.size()) {
+        int diff = numSpheres - (int)spheres.size();
         for (int i = 0; i < diff; i++) {
-            actors.push_back(CreateSphere());
+            spheres.push_back(CreateSphere());
         }
     }
-    else if (numSpheres < (int)actors.size()) {
-        int diff = (int)actors.size() - numSpheres;
+    else if (numSpheres < (int)spheres.size()) {
+        int diff = (int)spheres.size() - numSpheres;
         for (int i = 0; i < diff; i++) {
-            renderer->RemoveViewProp(actors.back());
-            actors.back()->Delete();
-            actors.pop_back();
+            DeleteSphere(spheres.back());
+            spheres.pop_back();
         }
     }
 
     double height = job->GetHeight() * 0.5;
-    for (int i = 0; i < (int)actors.size(); i++) {
-        actors[i]->SetPosition(pos1.X(), pos1.Y(), pos1.Z());
-        actors[i]->AddPosition(vec.X() * offset + vec.X() * spacing * i, 
-                               vec.Y() * offset + vec.Y() * spacing * i,
-                               vec.Z() * offset + vec.Z() * spacing * i);
-        actors[i]->SetScale(radius, radius, height);
+    for (int i = 0; i < (int)spheres.size(); i++) {
+        SetSpherePosition(spheres[i], pos1 + vec * (offset + spacing * i));
+        SetSphereScale(spheres[i], radius, radius, height);
     }
 }
 
@@ -229,7 +272,7 @@ void DataTransfer::DoColor() {
         r = sourceColor[0] * (1.0 - frac) + jobColor[0] * frac;
         g = sourceColor[1] * (1.0 - frac) + jobColor[1] * frac;
         b = sourceColor[2] * (1.0 - frac) + jobColor[2] * frac;
-        fromSource[i]->GetProperty()->SetColor(r, g, b);
+        SetSphereColor(fromSource[i], r, g, b);
         thisNum++;
     }    
     for (int i = 0; i < (int)toJob.size(); i++) {
@@ -237,10 +280,10 @@ void DataTransfer::DoColor() {
         r = sourceColor[0] * (1.0 - frac) + jobColor[0] * frac;
         g = sourceColor[1] * (1.0 - frac) + jobColor[1] * frac;
         b = sourceColor[2] * (1.0 - frac) + jobColor[2] * frac;
-        toJob[i]->GetProperty()->SetColor(r, g, b);
+        SetSphereColor(toJob[i], r, g, b);
         thisNum++;
     }
-    atJob->GetProperty()->SetColor(jobColor[0], jobColor[1], jobColor[2]);
+    SetSphereColor(atJob, jobColor[0], jobColor[1], jobColor[2]);
 
     fromSourceLineActor->GetProperty()->SetColor(jobColor[0], jobColor[1], jobColor[2]);
     toJobLineActor->GetProperty()->SetColor(jobColor[0], jobColor[1], jobColor[2]);
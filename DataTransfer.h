@@ -13,15 +13,14 @@
 #define DATATRANSFER_H
 
 
-#include <vtkLineSource.h>
-#include <vtkPolyDataMapper.h>
+#include <vtkActor.h>
 #include <vtkRenderer.h>
-#include <vtkSphereSource.h>
 
 #include <vector>
 
 #include <Vec3.h>
 
+#include "BatchRenderer.h"
 #include "Job.h"
 #include "NetworkConnection.h"
 #include "Site.h"
@@ -34,26 +33,30 @@ class Site;
 
 class DataTransfer {
 public:
-    DataTransfer(Site* sourceSite, Site* sinkSite, NetworkConnection* connection, Job* requester, double dataSize, vtkRenderer* ren);
+    DataTransfer(Site* sourceSite, Site* sinkSite, NetworkConnection* connection, Job* requester, double dataSize, vtkRenderer* ren,
+                 BatchRenderer* batchRenderer = NULL);
     ~DataTransfer();
 
     void SetOpacity(double sphereOpacity);
 
-    void Update();
+    // Move the spheres by a number of animation steps.  Returns true if they moved.
+    bool Update(int numSteps);
 
 private:
-    // Sphere and mapper used for multiple spheres
-    vtkSphereSource* sphere;
-    vtkPolyDataMapper* mapper;
-
-    // Sphere actors
-    std::vector<vtkActor*> fromSource;
-    std::vector<vtkActor*> toJob;
-    vtkActor* atJob;
-
-    // Lines
-    vtkLineSource* fromSourceLine;
-    vtkLineSource* toJobLine;
+    // A sphere is a row in the batch renderer's transfer spheres, or its own actor if there
+    // is no batch renderer
+    struct Sphere {
+        vtkActor* actor;
+        int row;
+    };
+
+    std::vector<Sphere> fromSource;
+    std::vector<Sphere> toJob;
+    Sphere atJob;
+
+    BatchRenderer* batch;
+
+    // Lines.  These and the spheres use shared unit geometry.
     vtkActor* fromSourceLineActor;
     vtkActor* toJobLineActor;
 
@@ -81,8 +84,14 @@ private:
 
     vtkRenderer* renderer;
 
-    vtkActor* CreateSphere();
-    void DoUpdate(std::vector<vtkActor*>& actors, const Vec3& pos1, const Vec3& pos2, double radius, double spacing);
+    Sphere CreateSphere();
+    void DeleteSphere(const Sphere& sphere);
+    void SetSpherePosition(const Sphere& sphere, const Vec3& pos);
+    void SetSphereScale(const Sphere& sphere, double x, double y, double z);
+    void SetSphereColor(const Sphere& sphere, double r, double g, double b);
+    void SetSphereOpacity(const Sphere& sphere, double sphereOpacity);
+
+    void DoUpdate(std::vector<Sphere>& spheres, const Vec3& pos1, const Vec3& pos2, double radius, double spacing);
     void DoColor();
 };
 
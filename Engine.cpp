@@ -13,6 +13,7 @@
 #include "Engine.h"
 
 #include "ConfigFileParser.h"
+#include "GeometryCache.h"
 #include "Projector.h"
 
 #include <wx/log.h>
@@ -28,7 +29,10 @@ Engine::Engine() {
 
 
     // Get timer Intervals
-    initialSocketReadInterval = parser->GetSocketReadInterval();
+    socketReadInterval = parser->GetSocketReadInterval();
+    socketLinesPerRead = parser->GetSocketLinesPerRead();
+    replaySpeed = parser->GetReplaySpeed();
+    snapshotLines = parser->GetSnapshotLines();
     initialGraphicsUpdateInterval = parser->GetGraphicsUpdateInterval();
     resetSeconds = parser->GetResetSeconds();
 
@@ -84,10 +88,11 @@ Engine::Engine() {
 
 
     // Create the list of jobs
-    jobList = new JobList(matching, static_cast<DoneSite*>(done), pipeline->GetRenderer(), darkBackground);
+    jobList = new JobList(matching, static_cast<DoneSite*>(done), pipeline->GetRenderer(), darkBackground, parser->InstancedJobGlyphs());
     jobList->SetJobRadius(parser->GetObjectRadius());
     jobList->SetJobHeight(parser->GetJobHeight());
     jobList->SetJobVelocity(parser->GetJobVelocity());
+    jobList->SetTimeStep(initialGraphicsUpdateInterval / 1000.0);
     jobList->ShowGlyphs(parser->GetShowGlyphs());
     jobList->ShowGhosts(parser->ShowGhostJobs());
     jobList->FadeGhosts(parser->FadeGhostJobs());
@@ -95,6 +100,12 @@ Engine::Engine() {
     jobList->ShowTrails(parser->ShowJobTrails());
     jobList->SetLabelHeight(parser->GetLabelHeight());
     jobList->LabelFaceCamera(parser->LabelFaceCamera());
+    jobList->SetRetainDoneJobs(parser->GetRetainDoneJobs());
+    jobList->SetRetainDoneSeconds(parser->GetRetainDoneSeconds());
+    jobList->SetRememberRetiredJobs(parser->GetRememberRetiredJobs());
+
+    // Level of detail
+    lodDistance = parser->GetLODDistance();
     
     // Set the science legend
     pipeline->SetScienceLegend(jobList->GetScienceLegend());
@@ -122,6 +133,10 @@ Engine::Engine() {
     // Create the list of network connections
     networkConnectionList = new NetworkConnectionList(pipeline->GetRenderer(), darkBackground);
 
+
+    // Parses data from the socket into the lists
+    eventParser = new EventParser(jobList, siteList, workflowList, networkConnectionList);
+
     
     // Keypress callback
     keyPressCallback = KeyPressCallback::New();
@@ -149,60 +164,150 @@ Engine::Engine() {
         dataFileNames.push_back("Data/OSG.data");
     }
 
+    binaryData = false;
+
     if (useSocket) {
         socket = new Socket(parser->GetSocketReadAll());
         socket->Init(hostNames[hostIndex].c_str(), ports[hostIndex]);
         workflowList->SetDefaultLabel(hostDescriptions[hostIndex]);
     }
     else {
-        socket = new TextFileSocket(parser->GetSocketReadAll());
+        socket = NewFileSocket(parser->GetSocketReadAll());
         socket->Init(dataFileNames[dataFileIndex].c_str());        
         workflowList->SetDefaultLabel(dataFileDescriptions[dataFileIndex]);
     }
 
     // No pause to start
     pause = false;
+    needsRender = true;
+
+    // Start reading
+    socketQueue = new EventQueue<std::string>();
+    socketThread = NULL;
+    StartSocketThread();
 }
 
 
 Engine::~Engine() {
     // Clean up
+    StopSocketThread();
+    delete socketQueue;
+
     keyPressCallback->Delete();
     delete socket;
+    delete eventParser;
     delete siteList;
     delete jobList;
     delete workflowList;
     delete pipeline;
+
+    GeometryCache::Clear();
 }
 
 
 void Engine::UpdateSocket() {
     if (pause) return;
 
-    std::string s;
-
-    socket->Read(s);
+    // Drain everything the socket thread has read since the last update
+    while (socketQueue->Pop(socketData)) {
+        if (!socketData.empty()) {
+            // The socket thread converts text to binary events
+            ParseSocketData(socketData, true);
+        }
 
-    if (!s.empty()) {
-        ParseSocketData(s);
+        socketData.clear();
     }
 
-    s.clear();
+    // Apply the net change to each job once, so states that are never drawn cost nothing
+    eventParser->Flush();
+
+    // Only render for events that changed what is drawn
+    if (eventParser->GetSceneChanged()) {
+        needsRender = true;
+        eventParser->ClearSceneChanged();
+    }
 }
 
 void Engine::UpdateGraphics() {
-    if (pause) return;
+    if (!pause) {
+        UpdateSocket();
+
+        if (siteList->Arrange()) needsRender = true;
+        if (jobList->UpdatePositions()) needsRender = true;
+        if (jobList->RetireJobs(workflowList)) needsRender = true;
+        if (pipeline->Update()) needsRender = true;
+    }
 
-    siteList->Arrange();
-    jobList->UpdatePositions();
-    pipeline->Update();
+    // Labels are placed for the current view, so update them when paused too
+    if (jobList->UpdateLabels()) needsRender = true;
+    if (siteList->UpdateLabels()) needsRender = true;
+
+    // Switch between jobs and site bars with the camera distance
+    bool showBars = lodDistance > 0.0 && pipeline->GetCameraDistance() > lodDistance;
+    if (showBars != siteList->GetShowBars()) {
+        siteList->ShowBars(showBars);
+        jobList->ShowDetail(!showBars);
+        needsRender = true;
+    }
+    if (siteList->UpdateBars()) needsRender = true;
+
+    // Only render if something changed or is animating
+    if (needsRender) {
+        pipeline->Render();
+        needsRender = false;
+    }
+}
 
-    pipeline->Render();
+void Engine::RequestRender() {
+    needsRender = true;
 }
 
 
-int Engine::GetInitialSocketReadInterval() {
-    return initialSocketReadInterval;
+int Engine::GetSocketReadInterval() {
+    return socketReadInterval;
+}
+
+void Engine::SetSocketReadInterval(int interval) {
+    socketReadInterval = interval;
+
+    if (socketThread) socketThread->SetReadInterval(socketReadInterval);
+}
+
+
+double Engine::GetReplaySpeed() {
+    return replaySpeed;
+}
+
+void Engine::SetReplaySpeed(double speed) {
+    replaySpeed = speed;
+
+    if (!useSocket) static_cast<TextFileSocket*>(socket)->SetReplaySpeed(replaySpeed);
+}
+
+
+void Engine::Seek(double position) {
+    if (useSocket) return;
+
+    StopSocketThread();
+
+    // Throw away anything read before the seek
+    socketQueue->Clear();
+
+    // Recreate the model at the new position.  Keep the science colors so they don't change.
+    ResetData(true);
+
+    std::string s;
+    static_cast<TextFileSocket*>(socket)->Seek(position, s);
+    if (!s.empty()) ParseSocketData(s, binaryData);
+    eventParser->Flush();
+
+    StartSocketThread();
+}
+
+bool Engine::GetReplayTimeRange(double& start, double& end) {
+    if (useSocket) return false;
+
+    return static_cast<TextFileSocket*>(socket)->GetTimeRange(start, end);
 }
 
 
@@ -259,6 +364,11 @@ int Engine::GetNumDataFiles() {
 
 void Engine::TogglePause() {
     pause = !pause;
+
+    if (socketThread) socketThread->SetPaused(pause);
+
+    // Don't animate the time spent paused
+    if (!pause) jobList->ResetClock();
 }
 
 
@@ -270,20 +380,26 @@ bool Engine::GetUseSocket() {
 void Engine::Reset() {
     bool readAll = socket->GetReadAll();
 
+    StopSocketThread();
+
     delete socket;
 
+    binaryData = false;
+
     if (useSocket) {
         socket = new Socket(readAll);
         socket->Init(hostNames[hostIndex].c_str(), ports[hostIndex]);
         workflowList->SetDefaultLabel(hostDescriptions[hostIndex]);
     }
     else {
-        socket = new TextFileSocket(readAll);
+        socket = NewFileSocket(readAll);
         socket->Init(dataFileNames[dataFileIndex].c_str());
         workflowList->SetDefaultLabel(dataFileDescriptions[dataFileIndex]);
     }
     
     ResetData();
+
+    StartSocketThread();
 }
 
 
@@ -318,258 +434,53 @@ void Engine::UseDataFile(int dataFile) {
 
 void Engine::ChangeWorkflow() {
     workflowList->ChangeCurrent();
-}   
-
-
-void Engine::ParseSocketData(std::string& s) {
-//    wxLogMessage("%s", s.c_str());
 
-    // Create a vector of the lines in the string
-    std::vector<std::string> lines = Tokenize(s, "\n");
+    needsRender = true;
+}   
 
-    // Parse each line
-    for (int i = 0; i < (int)lines.size(); i++) {
-        // If the line is "EOF", reset the data.
-        if (lines[i] == "EOF") {
-            ResetData();
-            return;
-        }
 
-        std::vector<std::string> tokens = Tokenize(lines[i], " \n");
+void Engine::ParseSocketData(std::string& s, bool binary) {
+    bool ok = binary ? eventParser->ParseBinary(s) : eventParser->Parse(s);
 
-        // Check for something
-        if (tokens.size() <= 0) {
-            wxLogMessage("Empty line");
-            continue;
-        }
+    // If the data ended with "EOF", reset the data
+    if (!ok) ResetData();
+}
 
-        // Validate
-        if (tokens.size() == 1 && tokens[0] == "ping") {
-            // Ignore
-            continue;
-        }
 
-        if (tokens[2] == "longlat" && tokens.size() == 5) {
-            // Okay, do nothing
-        }        
-        else if (tokens[0] == "workflow" && tokens.size() == 6) {
-            // Okay, do nothing
-        }
-        else if (tokens[0] == "network_bandwidth" && tokens.size() == 6) {
-            // Okay, do nothing
-        }
-        else if (tokens[2] == "data_source" && tokens.size() == 10) {
-            // Okay, do nothing
-        }
-        else if (tokens.size() == 4 || tokens.size() == 6) {
-            // Okay, do nothing
-        }
-        else {
-            // Wrong number of tokens
-            wxLogMessage("Invalid number of tokens: %s", lines[i].c_str());
-            continue;
-        }
+TextFileSocket* Engine::NewFileSocket(bool readAll) {
+    // Binary event files are recognized by their header
+    binaryData = BinaryFileSocket::IsBinaryFile(dataFileNames[dataFileIndex].c_str());
 
-        // Parse the line
-        if (tokens[0] == "job") {
-            std::string jobID = tokens[1];
-            std::string command = tokens[2];
-
-            // Get or create this job
-            Job* job = jobList->Get(jobID, workflowList);
-
-            if (command == "state") {
-                std::string state = tokens[3];
-
-                if (!job->SetState(state)) {
-                    wxLogMessage("Invalid job state: %s", state.c_str());
-                    continue;
-                }
-
-                // Check for science
-                if (tokens.size() == 6) {
-                    if (tokens[4] == "science") {
-                        std::string science = tokens[5];
-
-                        const double* color = jobList->GetScienceColor(science);
-
-                        job->SetScienceColor(color[0], color[1], color[2]);
-                    }
-                }
-/*
-// For testing colors
-else {
-    std::vector<std::string> scienceNames;
-/*
-    for (int i = 0; i < 20; i++) {
-        std::string name = "Science_";
-        char number[16];
-        sprintf(number, "%d", i);
-        name += number;
-        scienceNames.push_back(name);
+    if (binaryData) {
+        return new BinaryFileSocket(readAll, socketLinesPerRead, replaySpeed, snapshotLines);
     }
-*/
-/*
-    scienceNames.push_back("Math");
-    scienceNames.push_back("Biology");
-    scienceNames.push_back("Chemistry");
-    scienceNames.push_back("Physics");
-    scienceNames.push_back("Geology");
-    scienceNames.push_back("Astronomy");
-    scienceNames.push_back("Bioinformatics");
-    scienceNames.push_back("Medicine");
-    scienceNames.push_back("Alchemy");
-    scienceNames.push_back("Parapsychology");
-
-    int index = rand() % scienceNames.size();
-
-    const double* color = jobList->GetScienceColor(scienceNames[index]);
-
-    job->SetScienceColor(color[0], color[1], color[2]);
-}
-*/
-
-                if (job->IsDone() && job->GetName().size() > 0) {
-                    // Check for duplicates
-                    std::vector<std::string> jobIDs = workflowList->RemoveDuplicates(job);
-
-                    if (jobIDs.size() > 0) jobList->RemoveDuplicates(jobIDs);
-                }
-            }
-            else if (command == "tosite") {
-                std::string siteID = tokens[3];
-
-                // Get or create this site
-                Site* site = siteList->Get(siteID);
- 
-                site->AttachJob(job);
-            }
-            else if (command == "workflow") {
-                std::string workflowID = tokens[3];
-
-                // Get or create this workflow
-                Workflow* workflow = workflowList->Get(workflowID);
-
-                workflow->InsertJob(job);
-            }
-            else if (command == "job_name") {
-                std::string jobName = tokens[3];
-
-                // Set the name
-                job->SetName(jobName);
-
-                // XXX : Check for duplicates
-            }
-            else if (command == "data_source") {
-                std::string dataSourceID = tokens[3];
-                std::string dataSinkID = tokens[5];
-                double dataSize = atof(tokens[7].c_str());
-
-                // Ignore if sourceID and destID are the same or dataSize <= 0.0
-                if (dataSourceID == dataSinkID || dataSize <= 0.0) continue;
-
-                // Get or create these sites
-                Site* dataSource = siteList->Get(dataSourceID);
-                Site* dataSink = siteList->Get(dataSinkID);
-
-                // Get or create this network connection
-                NetworkConnection* connection = networkConnectionList->Get(dataSource, dataSink);
-
-                // Start the data transfer
-                job->StartDataTransfer(dataSource, dataSink, connection, dataSize);
-            }   
-            else if (command == "localid") {
-                // Ignore for now
-                continue;
-            }
-            else {
-                wxLogMessage("Invalid job command: %s", command.c_str());
-                continue;
-            }
-        }
-        else if (tokens[0] == "site") {
-            std::string siteID = tokens[1];
-            std::string command = tokens[2];
-
-            // Get or create this site
-            Site* site = siteList->Get(siteID);
-
-            if (command == "rank") {
-                std::string rank = tokens[3];               
-
-                site->SetRank(rank);
-            }
-            else if (command == "longlat") {
-                std::string longitude = tokens[3];
-                std::string latitude = tokens[4];
-
-                site->SetLongLat(atof(longitude.c_str()), atof(latitude.c_str()));
-            }
-            else {
-                wxLogMessage("Invalid site command", command.c_str());
-                continue;
-            }
-        }
-        else if (tokens[0] == "workflow") {
-            std::string workflowID = tokens[1];
-            std::string username = tokens[3];
-            std::string workflowName = tokens[5];
-
-            // Get or create this workflow
-            Workflow* workflow = workflowList->Get(workflowID);
-
-            workflow->SetUsername(username);
-            workflow->SetName(workflowName);
-        }
-        else if (tokens[0] == "network_bandwidth") {
-            std::string sourceID = tokens[2];
-            std::string destID = tokens[4];
-            double bandwidth = atof(tokens[5].c_str());
-
-            // Ignore if sourceID and destID are the same or bandwidth <= 0.0
-            if (sourceID == destID || bandwidth <= 0.0) continue;
-
-            // Get or create these sites
-            Site* source = siteList->Get(sourceID);
-            Site* dest = siteList->Get(destID);
-
-            // Get or create this network connection
-            NetworkConnection* connection = networkConnectionList->Get(source, dest);
-
-            // Set the bandwidth
-            connection->SetBandwidth(bandwidth);
-        }
-        else {
-            wxLogMessage("Invalid command: %s", tokens[0].c_str());
-            continue;
-        }
+    else {
+        return new TextFileSocket(readAll, socketLinesPerRead, replaySpeed, snapshotLines);
     }
-
-    pipeline->Render();
 }
-    
 
-std::vector<std::string> Engine::Tokenize(const std::string& s, const std::string& delimiters) {
-    std::vector<std::string> tokens;
 
-    // Skip delimiters at the beginning
-    std::string::size_type lastPos = s.find_first_not_of(delimiters, 0);
+void Engine::StartSocketThread() {
+    socketThread = new SocketThread(socket, socketQueue, socketReadInterval, binaryData);
+    socketThread->SetPaused(pause);
 
-    // Look for first token
-    std::string::size_type pos = s.find_first_of(delimiters, lastPos);
+    if (socketThread->Create() != wxTHREAD_NO_ERROR || socketThread->Run() != wxTHREAD_NO_ERROR) {
+        wxLogMessage("Couldn't start socket thread.");
 
-    while (pos != std::string::npos || lastPos != std::string::npos) {
-        // Found a token, add it to the vector
-        tokens.push_back(s.substr(lastPos, pos - lastPos));
-
-        // Skip delimiters
-        lastPos = s.find_first_not_of(delimiters, pos);
+        delete socketThread;
+        socketThread = NULL;
+    }
+}
 
-        // Look for next token
-        pos = s.find_first_of(delimiters, lastPos);
+void Engine::StopSocketThread() {
+    if (socketThread) {
+        socketThread->Stop();
+        delete socketThread;
+        socketThread = NULL;
     }
 
-    return tokens;
+    // Throw away anything read from the old socket
+    socketQueue->Clear();
 }
 
 
@@ -588,9 +499,9 @@ void Engine::CreateDefaultSites(Site* & matching, Site* & done) {
 }
 
 
-void Engine::ResetData() {
+void Engine::ResetData(bool keepScienceColors) {
     // Reset lists
-    jobList->Reset();
+    jobList->Reset(keepScienceColors);
     siteList->Reset();
     workflowList->Reset();
     networkConnectionList->Reset();
@@ -600,4 +511,6 @@ void Engine::ResetData() {
     Site* done = NULL;
     CreateDefaultSites(matching, done);
     jobList->SetDefaultSites(matching, static_cast<DoneSite*>(done));
+
+    needsRender = true;
 }   
@@ -19,6 +19,9 @@
 
 #include <vtkRenderWindowInteractor.h>
 
+#include "BinaryFileSocket.h"
+#include "EventParser.h"
+#include "EventQueue.h"
 #include "Job.h"
 #include "JobList.h"
 #include "NetworkConnectionList.h"
@@ -26,6 +29,7 @@
 #include "Site.h"
 #include "SiteList.h"
 #include "Socket.h"
+#include "SocketThread.h"
 #include "TextFileSocket.h"
 #include "WorkflowList.h"
 
@@ -38,7 +42,21 @@ public:
     void UpdateSocket();
     void UpdateGraphics();
 
-    int GetInitialSocketReadInterval();
+    // Render on the next graphics update, for changes made outside of the engine
+    void RequestRender();
+
+    int GetSocketReadInterval();
+    void SetSocketReadInterval(int interval);
+
+    // Multiple of real time to replay timestamped data files at.  0 ignores timestamps.
+    double GetReplaySpeed();
+    void SetReplaySpeed(double speed);
+
+    // Seek to a position in the data file, from 0 to 1
+    void Seek(double position);
+
+    // Recording times of the start and end of the data file, if it has timestamps
+    bool GetReplayTimeRange(double& start, double& end);
     int GetInitialGraphicsUpdateInterval();
     int GetResetSeconds();
 
@@ -72,6 +90,11 @@ private:
     // Socket for reading data
     Socket* socket;
 
+    // Thread for reading the socket, and the queue of binary events it fills
+    SocketThread* socketThread;
+    EventQueue<std::string>* socketQueue;
+    std::string socketData;
+
     // Data sources
     std::vector<std::string> hostDescriptions;
     std::vector<std::string> hostNames;
@@ -100,27 +123,53 @@ private:
     // For pausing/unpausing
     bool pause;
 
+    // Set when the scene has changed since the last render
+    bool needsRender;
+
+    // Camera distance past which sites draw bars instead of jobs, relative to the starting
+    // view, or 0 to always draw jobs
+    double lodDistance;
+
     // Reading from the socket or not
     bool useSocket;
     int hostIndex;
     int dataFileIndex;
 
     // Timer intervals, in milliseconds
-    int initialSocketReadInterval;
+    int socketReadInterval;
     int initialGraphicsUpdateInterval;
    
     // Timer interval, in seconds
     int resetSeconds;
 
-    // Functions for parsing data read from the socket
-    void ParseSocketData(std::string& s);
-    std::vector<std::string> Tokenize(const std::string& s, const std::string& delimiters);
+    // Lines per read when reading from a file
+    int socketLinesPerRead;
+
+    // Replay speed for timestamped files
+    double replaySpeed;
+
+    // Lines between replay snapshots when reading from a file
+    int snapshotLines;
+
+    // Parses data read from the socket, as text or binary events
+    EventParser* eventParser;
+    void ParseSocketData(std::string& s, bool binary);
+
+    // Reading a binary event file or not
+    bool binaryData;
+
+    // Create a socket for the current data file
+    TextFileSocket* NewFileSocket(bool readAll);
+
+    // Start and stop the socket thread
+    void StartSocketThread();
+    void StopSocketThread();
 
     // Create default sites
     void CreateDefaultSites(Site* & matching, Site* & done);
 
-    // Reset data
-    void ResetData();
+    // Reset data, optionally keeping the colors assigned to sciences
+    void ResetData(bool keepScienceColors = false);
 };
 
 
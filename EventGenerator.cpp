@@ -0,0 +1,245 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        EventGenerator.cpp
+//
+// Author:      David Borland
+//
+// Description: Implementation of EventGenerator class for MatchMaker.  Generates synthetic
+//              events in the MatchMaker line protocol, for load testing without a live feed.
+//              The same seed always gives the same events.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "EventGenerator.h"
+
+#include <stdio.h>
+
+
+EventGenerator::EventGenerator(int numberOfSites, int numberOfWorkflows, int maxActiveJobs, unsigned int seed)
+: numSites(numberOfSites), numWorkflows(numberOfWorkflows), maxJobs(maxActiveJobs) {
+    numSites = numSites < 1 ? 1 : numSites;
+    numWorkflows = numWorkflows < 1 ? 1 : numWorkflows;
+    maxJobs = maxJobs < 1 ? 1 : maxJobs;
+
+    nextJobID = 1;
+
+    // Defaults
+    failedFraction = 0.1;
+    dataTransferFraction = 0.2;
+    scienceFraction = 0.8;
+    siteUpdateFraction = 0.01;
+    maxRunSteps = 10;
+
+    scienceNames.push_back("Math");
+    scienceNames.push_back("Biology");
+    scienceNames.push_back("Chemistry");
+    scienceNames.push_back("Physics");
+    scienceNames.push_back("Geology");
+    scienceNames.push_back("Astronomy");
+    scienceNames.push_back("Bioinformatics");
+    scienceNames.push_back("Medicine");
+
+    // Zero is not a valid state
+    randomState = seed != 0 ? seed : 1;
+}
+
+EventGenerator::~EventGenerator() {
+}
+
+
+void EventGenerator::SetFailedFraction(double fraction) {
+    failedFraction = fraction;
+}
+
+void EventGenerator::SetDataTransferFraction(double fraction) {
+    dataTransferFraction = fraction;
+}
+
+void EventGenerator::SetScienceFraction(double fraction) {
+    scienceFraction = fraction;
+}
+
+void EventGenerator::SetMaxRunSteps(int steps) {
+    maxRunSteps = steps < 0 ? 0 : steps;
+}
+
+void EventGenerator::SetSiteUpdateFraction(double fraction) {
+    siteUpdateFraction = fraction;
+}
+
+
+void EventGenerator::GenerateSetup(std::string& s) {
+    for (int i = 0; i < numSites; i++) {
+        double longitude, latitude;
+        SiteLongLat(i, longitude, latitude);
+
+        sprintf_s(line, sizeof(line), "site SITE_%d longlat %.4f %.4f\n", i, longitude, latitude);
+        s += line;
+
+        sprintf_s(line, sizeof(line), "site SITE_%d rank %d\n", i, RandomInt(1001));
+        s += line;
+    }
+
+    for (int i = 0; i < numWorkflows; i++) {
+        sprintf_s(line, sizeof(line), "workflow WORKFLOW_%d username user_%d name Workflow_%d\n", i, i % 10, i);
+        s += line;
+    }
+}
+
+
+int EventGenerator::Generate(int numLines, std::string& s) {
+    int count = 0;
+
+    while (count < numLines) {
+        if (RandomFraction() < siteUpdateFraction) {
+            count += SiteUpdate(s);
+        }
+        else if (jobs.empty() || ((int)jobs.size() < maxJobs && RandomFraction() < 0.5)) {
+            count += NewJob(s);
+        }
+        else {
+            count += AdvanceJob(RandomInt((int)jobs.size()), s);
+        }
+    }
+
+    return count;
+}
+
+
+int EventGenerator::GetNumActiveJobs() {
+    return (int)jobs.size();
+}
+
+int EventGenerator::GetNumJobsCreated() {
+    return nextJobID - 1;
+}
+
+
+unsigned int EventGenerator::Random() {
+    // Xorshift
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+
+    return randomState;
+}
+
+double EventGenerator::RandomFraction() {
+    return (double)(Random() & 0xFFFFFF) / (double)0x1000000;
+}
+
+int EventGenerator::RandomInt(int n) {
+    return (int)(Random() % (unsigned int)n);
+}
+
+
+void EventGenerator::SiteLongLat(int site, double& longitude, double& latitude) {
+    // Hash the site number so positions don't depend on the order events are generated
+    unsigned int h = (unsigned int)site * 2654435761u + 1;
+    h ^= h << 13;
+    h ^= h >> 17;
+    h ^= h << 5;
+
+    longitude = -124.0 + (double)(h & 0xFFFF) / 65535.0 * 57.0;
+    latitude = 25.0 + (double)(h >> 16) / 65535.0 * 24.0;
+}
+
+
+int EventGenerator::NewJob(std::string& s) {
+    GeneratedJob job;
+    job.id = nextJobID++;
+    job.site = RandomInt(numSites);
+    job.step = ToSite;
+    job.runSteps = maxRunSteps > 0 ? RandomInt(maxRunSteps + 1) : 0;
+    job.fails = RandomFraction() < failedFraction;
+    job.transfers = RandomFraction() < dataTransferFraction;
+
+    jobs.push_back(job);
+
+    // New jobs start out matching
+    if (RandomFraction() < scienceFraction) {
+        sprintf_s(line, sizeof(line), "job %d state MATCHING science %s\n",
+                  job.id, scienceNames[RandomInt((int)scienceNames.size())].c_str());
+    }
+    else {
+        sprintf_s(line, sizeof(line), "job %d state MATCHING\n", job.id);
+    }
+    s += line;
+
+    sprintf_s(line, sizeof(line), "job %d workflow WORKFLOW_%d\n", job.id, RandomInt(numWorkflows));
+    s += line;
+
+    sprintf_s(line, sizeof(line), "job %d job_name gen_job_%d\n", job.id, job.id);
+    s += line;
+
+    return 3;
+}
+
+
+int EventGenerator::AdvanceJob(int index, std::string& s) {
+    GeneratedJob& job = jobs[index];
+
+    if (job.step == ToSite) {
+        sprintf_s(line, sizeof(line), "job %d tosite SITE_%d\n", job.id, job.site);
+        job.step = Submitting;
+    }
+    else if (job.step == Submitting) {
+        sprintf_s(line, sizeof(line), "job %d state SUBMITTING\n", job.id);
+        job.step = Queued;
+    }
+    else if (job.step == Queued) {
+        sprintf_s(line, sizeof(line), "job %d state QUEUED\n", job.id);
+        job.step = Running;
+    }
+    else if (job.step == Running) {
+        sprintf_s(line, sizeof(line), "job %d state RUNNING\n", job.id);
+        job.step = Finished;
+    }
+    else if (job.runSteps > 0) {
+        // Still running
+        job.runSteps--;
+
+        if (job.transfers && numSites > 1) {
+            // Pull data from another site
+            int source = RandomInt(numSites - 1);
+            if (source >= job.site) source++;
+
+            sprintf_s(line, sizeof(line), "job %d data_source SITE_%d data_sink SITE_%d data_size %d data_time 0\n",
+                      job.id, source, job.site, 1 + RandomInt(1000));
+        }
+        else {
+            sprintf_s(line, sizeof(line), "job %d localid %d\n", job.id, job.id);
+        }
+    }
+    else {
+        sprintf_s(line, sizeof(line), "job %d state %s\n", job.id, job.fails ? "FAILED" : "DONE");
+
+        // Remove the job
+        jobs[index] = jobs.back();
+        jobs.pop_back();
+    }
+
+    s += line;
+
+    return 1;
+}
+
+
+int EventGenerator::SiteUpdate(std::string& s) {
+    if (numSites > 1 && RandomFraction() < 0.5) {
+        int source = RandomInt(numSites);
+        int dest = RandomInt(numSites - 1);
+        if (dest >= source) dest++;
+
+        sprintf_s(line, sizeof(line), "network_bandwidth source SITE_%d dest SITE_%d %.2f\n",
+                  source, dest, 1.0 + RandomFraction() * 999.0);
+    }
+    else {
+        sprintf_s(line, sizeof(line), "site SITE_%d rank %d\n", RandomInt(numSites), RandomInt(1001));
+    }
+
+    s += line;
+
+    return 1;
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        EventGenerator.h
+//
+// Author:      David Borland
+//
+// Description: Interface of EventGenerator class for MatchMaker.  Generates synthetic events
+//              in the MatchMaker line protocol, for load testing without a live feed.  The
+//              same seed always gives the same events.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef EVENTGENERATOR_H
+#define EVENTGENERATOR_H
+
+
+#include <string>
+#include <vector>
+
+
+class EventGenerator {
+public:
+    EventGenerator(int numberOfSites, int numberOfWorkflows, int maxActiveJobs, unsigned int seed = 1);
+    ~EventGenerator();
+
+    // Job lifecycle distributions
+    void SetFailedFraction(double fraction);
+    void SetDataTransferFraction(double fraction);
+    void SetScienceFraction(double fraction);
+    void SetMaxRunSteps(int steps);
+
+    // Fraction of events that update a site rank or network bandwidth
+    void SetSiteUpdateFraction(double fraction);
+
+    // Append the site and workflow descriptions to s
+    void GenerateSetup(std::string& s);
+
+    // Append at least numLines lines of job, site, and network events to s
+    int Generate(int numLines, std::string& s);
+
+    int GetNumActiveJobs();
+    int GetNumJobsCreated();
+
+private:
+    // Steps in a job's life
+    enum JobStep {
+        ToSite,
+        Submitting,
+        Queued,
+        Running,
+        Finished
+    };
+
+    struct GeneratedJob {
+        int id;
+        int site;
+        int step;
+        int runSteps;
+        bool fails;
+        bool transfers;
+    };
+
+    std::vector<GeneratedJob> jobs;
+
+    int numSites;
+    int numWorkflows;
+    int maxJobs;
+    int nextJobID;
+
+    double failedFraction;
+    double dataTransferFraction;
+    double scienceFraction;
+    double siteUpdateFraction;
+    int maxRunSteps;
+
+    std::vector<std::string> scienceNames;
+
+    // Buffer for formatting lines
+    char line[256];
+
+    // Simple random number generator, so results are the same on every platform
+    unsigned int randomState;
+    unsigned int Random();
+    double RandomFraction();
+    int RandomInt(int n);
+
+    // Site positions are random within the continental US
+    void SiteLongLat(int site, double& longitude, double& latitude);
+
+    // Generate lines, returning the number of lines added
+    int NewJob(std::string& s);
+    int AdvanceJob(int index, std::string& s);
+    int SiteUpdate(std::string& s);
+};
+
+
+#endif
\ No newline at end of file
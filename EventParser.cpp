@@ -0,0 +1,465 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        EventParser.cpp
+//
+// Author:      David Borland
+//
+// Description: Implementation of EventParser class for MatchMaker.  Parses lines of event data,
+//              or binary event records, and applies them to the job, site, workflow, and 
+//              network connection lists.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "EventParser.h"
+
+#include <wx/log.h>
+
+
+EventParser::EventParser(JobList* jobs, SiteList* sites, WorkflowList* workflows, NetworkConnectionList* connections)
+: jobList(jobs), siteList(sites), workflowList(workflows), networkConnectionList(connections) {
+    numPendingJobs = 0;
+    sceneChanged = false;
+}
+
+EventParser::~EventParser() {
+}
+
+
+bool EventParser::Parse(std::string& s) {
+//    wxLogMessage("%s", s.c_str());
+
+    // Tokens point into s, so no copies are made until a string is needed
+    Tokenizer tokens(s);
+
+    // Parse each line
+    while (tokens.NextLine()) {
+        int numTokens = tokens.GetNumTokens();
+
+        // If the line is "EOF", stop so the data can be reset
+        if (numTokens == 1 && tokens[0] == "EOF") {
+            ClearPending();
+            return false;
+        }
+
+        // Validate
+        if (numTokens == 1 && tokens[0] == "ping") {
+            // Ignore
+            continue;
+        }
+
+        if (tokens.TooManyTokens()) {
+            // Too many tokens
+            TokenString(tokens.GetLine(), 0);
+            wxLogMessage("Invalid number of tokens: %s", tokenStrings[0].c_str());
+            continue;
+        }
+        else if (numTokens == 5 && tokens[2] == "longlat") {
+            // Okay, do nothing
+        }        
+        else if (numTokens == 6 && tokens[0] == "workflow") {
+            // Okay, do nothing
+        }
+        else if (numTokens == 6 && tokens[0] == "network_bandwidth") {
+            // Okay, do nothing
+        }
+        else if (numTokens == 10 && tokens[2] == "data_source") {
+            // Okay, do nothing
+        }
+        else if (numTokens == 4 || numTokens == 6) {
+            // Okay, do nothing
+        }
+        else {
+            // Wrong number of tokens
+            TokenString(tokens.GetLine(), 0);
+            wxLogMessage("Invalid number of tokens: %s", tokenStrings[0].c_str());
+            continue;
+        }
+
+        // Job events wait for a flush, so apply them before any other event, in the order
+        // they were sent
+        if (tokens[0] != "job") Flush();
+
+        // Parse the line
+        if (tokens[0] == "job") {
+            const Token& command = tokens[2];
+
+            if (command == "localid") {
+                // Ignore for now
+                continue;
+            }
+
+            // Get or create the pending changes for this job
+            PendingJob& job = GetPendingJob(TokenString(tokens[1], 1));
+
+            if (command == "state") {
+                // Check for science
+                const std::string* science = NULL;
+                if (numTokens == 6 && tokens[4] == "science") {
+                    science = &TokenString(tokens[5], 5);
+                }
+
+                SetJobState(job, TokenString(tokens[3], 3), science);
+            }
+            else if (command == "tosite") {
+                job.hasSite = true;
+                tokens[3].CopyTo(job.site);
+            }
+            else if (command == "workflow") {
+                job.hasWorkflow = true;
+                tokens[3].CopyTo(job.workflow);
+            }
+            else if (command == "job_name") {
+                job.hasName = true;
+                tokens[3].CopyTo(job.name);
+
+                // XXX : Check for duplicates
+            }
+            else if (command == "data_source") {
+                StartDataTransfer(job, TokenString(tokens[3], 3), TokenString(tokens[5], 5), tokens[7].ToDouble());
+            }   
+            else {
+                wxLogMessage("Invalid job command: %s", TokenString(command, 2).c_str());
+                continue;
+            }
+        }
+        else if (tokens[0] == "site") {
+            const std::string& siteID = TokenString(tokens[1], 1);
+            const Token& command = tokens[2];
+
+            // Get or create this site
+            Site* site = siteList->Get(siteID);
+
+            if (command == "rank") {
+                site->SetRank(tokens[3].ToDouble());
+                sceneChanged = true;
+            }
+            else if (command == "longlat") {
+                double longitude = tokens[3].ToDouble();
+                double latitude = tokens[4].ToDouble();
+
+                site->SetLongLat(longitude, latitude);
+                sceneChanged = true;
+            }
+            else {
+                wxLogMessage("Invalid site command: %s", TokenString(command, 2).c_str());
+                continue;
+            }
+        }
+        else if (tokens[0] == "workflow") {
+            SetWorkflow(TokenString(tokens[1], 1), TokenString(tokens[3], 3), TokenString(tokens[5], 5));
+        }
+        else if (tokens[0] == "network_bandwidth") {
+            SetBandwidth(TokenString(tokens[2], 2), TokenString(tokens[4], 4), tokens[5].ToDouble());
+        }
+        else {
+            wxLogMessage("Invalid command: %s", TokenString(tokens[0], 0).c_str());
+            continue;
+        }
+    }
+
+    return true;
+}
+
+
+bool EventParser::ParseBinary(const std::string& s) {
+    const char* data = s.c_str();
+    size_t size = s.size();
+    size_t position = 0;
+
+    while (position < size) {
+        size_t recordSize = BinaryEvent::RecordSize(data + position, size - position);
+        if (recordSize == 0) {
+            wxLogMessage("Invalid binary event record");
+            break;
+        }
+
+        const char* record = data + position + 1;
+        unsigned char opcode = (unsigned char)data[position];
+
+        position += recordSize;
+
+        if (opcode == BinaryEvent::OpString) {
+            // Add this string to the table
+            unsigned int id = BinaryEvent::ReadUInt(record);
+            if (id >= strings.size()) strings.resize(id + 1);
+
+            strings[id].assign(record + 6, recordSize - 7);
+
+            continue;
+        }
+        else if (opcode == BinaryEvent::OpEndOfFile) {
+            // The strings are sent again from the start of the file
+            strings.clear();
+            ClearPending();
+
+            return false;
+        }
+        else if (opcode == BinaryEvent::OpTimestamp) {
+            // Only used for pacing
+            continue;
+        }
+
+        // Every other record starts with a string.  Records with unknown strings are skipped.
+        const std::string* s1 = String(record);
+        if (!s1) continue;
+
+        // Job events wait for a flush, so apply them before any other event, in the order
+        // they were sent
+        if (opcode == BinaryEvent::OpSiteRank || opcode == BinaryEvent::OpSiteLongLat ||
+            opcode == BinaryEvent::OpWorkflow || opcode == BinaryEvent::OpNetworkBandwidth) {
+            Flush();
+        }
+
+        switch (opcode) {
+            case BinaryEvent::OpJobState: {
+                const std::string* state = String(record + 4);
+                if (!state) break;
+
+                unsigned int science = BinaryEvent::ReadUInt(record + 8);
+
+                SetJobState(GetPendingJob(*s1), *state, science == BinaryEvent::NoString ? NULL : String(record + 8));
+                break;
+            }
+
+            case BinaryEvent::OpJobToSite: {
+                const std::string* siteID = String(record + 4);
+                if (!siteID) break;
+
+                PendingJob& job = GetPendingJob(*s1);
+                job.hasSite = true;
+                job.site = *siteID;
+                break;
+            }
+
+            case BinaryEvent::OpJobWorkflow: {
+                const std::string* workflowID = String(record + 4);
+                if (!workflowID) break;
+
+                PendingJob& job = GetPendingJob(*s1);
+                job.hasWorkflow = true;
+                job.workflow = *workflowID;
+                break;
+            }
+
+            case BinaryEvent::OpJobName: {
+                const std::string* jobName = String(record + 4);
+                if (!jobName) break;
+
+                PendingJob& job = GetPendingJob(*s1);
+                job.hasName = true;
+                job.name = *jobName;
+                break;
+            }
+
+            case BinaryEvent::OpJobDataSource: {
+                const std::string* dataSourceID = String(record + 4);
+                const std::string* dataSinkID = String(record + 8);
+                if (dataSourceID && dataSinkID) {
+                    StartDataTransfer(GetPendingJob(*s1), *dataSourceID, *dataSinkID, BinaryEvent::ReadDouble(record + 12));
+                }
+                break;
+            }
+
+            case BinaryEvent::OpSiteRank:
+                siteList->Get(*s1)->SetRank(BinaryEvent::ReadDouble(record + 4));
+                sceneChanged = true;
+                break;
+
+            case BinaryEvent::OpSiteLongLat:
+                siteList->Get(*s1)->SetLongLat(BinaryEvent::ReadDouble(record + 4), BinaryEvent::ReadDouble(record + 12));
+                sceneChanged = true;
+                break;
+
+            case BinaryEvent::OpWorkflow: {
+                const std::string* username = String(record + 4);
+                const std::string* workflowName = String(record + 8);
+                if (username && workflowName) SetWorkflow(*s1, *username, *workflowName);
+                break;
+            }
+
+            case BinaryEvent::OpNetworkBandwidth: {
+                const std::string* destID = String(record + 4);
+                if (destID) SetBandwidth(*s1, *destID, BinaryEvent::ReadDouble(record + 8));
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+void EventParser::Flush() {
+    // Apply the net changes to each job, in the order the jobs were first seen.  Every pending
+    // job creates or changes a job.
+    for (int i = 0; i < numPendingJobs; i++) {
+        ApplyPendingJob(pendingJobs[i]);
+    }
+    if (numPendingJobs > 0) sceneChanged = true;
+
+    ClearPending();
+}
+
+
+bool EventParser::GetSceneChanged() {
+    return sceneChanged;
+}
+
+void EventParser::ClearSceneChanged() {
+    sceneChanged = false;
+}
+
+
+void EventParser::SetJobState(PendingJob& job, const std::string& state, const std::string* science) {
+    if (!Job::IsValidState(state)) {
+        wxLogMessage("Invalid job state: %s", state.c_str());
+        return;
+    }
+
+    job.hasState = true;
+    job.state = state;
+
+    if (science) {
+        job.hasScience = true;
+        job.science = *science;
+    }
+
+    // Any state but matching stops a data transfer, so an earlier transfer is never seen
+    if (state != "MATCHING") job.hasDataTransfer = false;
+}
+
+
+void EventParser::StartDataTransfer(PendingJob& job, const std::string& dataSourceID, const std::string& dataSinkID, double dataSize) {
+    // Ignore if sourceID and destID are the same or dataSize <= 0.0
+    if (dataSourceID == dataSinkID || dataSize <= 0.0) return;
+
+    // Only the last transfer is kept
+    job.hasDataTransfer = true;
+    job.dataSourceID = dataSourceID;
+    job.dataSinkID = dataSinkID;
+    job.dataSize = dataSize;
+}
+
+
+EventParser::PendingJob& EventParser::GetPendingJob(const std::string& jobID) {
+    std::unordered_map<std::string, int>::iterator it = pendingJobIndex.find(jobID);
+    if (it != pendingJobIndex.end()) return pendingJobs[it->second];
+
+    // Reuse entries from earlier updates, so their strings don't need allocating
+    if (numPendingJobs == (int)pendingJobs.size()) pendingJobs.push_back(PendingJob());
+
+    PendingJob& job = pendingJobs[numPendingJobs];
+    job.id = jobID;
+    job.hasState = false;
+    job.hasScience = false;
+    job.hasSite = false;
+    job.hasWorkflow = false;
+    job.hasName = false;
+    job.hasDataTransfer = false;
+
+    pendingJobIndex[jobID] = numPendingJobs++;
+
+    return job;
+}
+
+
+void EventParser::ClearPending() {
+    numPendingJobs = 0;
+    pendingJobIndex.clear();
+}
+
+
+void EventParser::ApplyPendingJob(PendingJob& pending) {
+    // Get or create this job
+    Job* job = jobList->Get(pending.id, workflowList);
+
+    if (pending.hasWorkflow) {
+        // Get or create this workflow
+        Workflow* workflow = workflowList->Get(pending.workflow);
+
+        workflow->InsertJob(job);
+    }
+
+    // Set the name before the state, so finished duplicates are found
+    if (pending.hasName) {
+        job->SetName(pending.name);
+    }
+
+    if (pending.hasState) {
+        job->SetState(pending.state);
+        jobList->JobStateChanged(job);
+
+        if (pending.hasScience) {
+            const double* color = jobList->GetScienceColor(pending.science);
+
+            job->SetScienceColor(color[0], color[1], color[2]);
+        }
+
+        if (job->IsDone() && job->GetName().size() > 0) {
+            // Check for duplicates
+            std::vector<std::string> jobIDs = workflowList->RemoveDuplicates(job);
+
+            if (jobIDs.size() > 0) jobList->RemoveDuplicates(jobIDs);
+        }
+    }
+
+    if (pending.hasSite) {
+        // Get or create this site
+        Site* site = siteList->Get(pending.site);
+ 
+        site->AttachJob(job);
+    }
+
+    if (pending.hasDataTransfer) {
+        // Get or create these sites
+        Site* dataSource = siteList->Get(pending.dataSourceID);
+        Site* dataSink = siteList->Get(pending.dataSinkID);
+
+        // Get or create this network connection
+        NetworkConnection* connection = networkConnectionList->Get(dataSource, dataSink);
+
+        // Start the data transfer
+        job->StartDataTransfer(dataSource, dataSink, connection, pending.dataSize);
+    }
+}
+
+
+void EventParser::SetWorkflow(const std::string& workflowID, const std::string& username, const std::string& workflowName) {
+    // Get or create this workflow
+    Workflow* workflow = workflowList->Get(workflowID);
+
+    workflow->SetUsername(username);
+    workflow->SetName(workflowName);
+}
+
+
+void EventParser::SetBandwidth(const std::string& sourceID, const std::string& destID, double bandwidth) {
+    // Ignore if sourceID and destID are the same or bandwidth <= 0.0
+    if (sourceID == destID || bandwidth <= 0.0) return;
+
+    // Get or create these sites
+    Site* source = siteList->Get(sourceID);
+    Site* dest = siteList->Get(destID);
+
+    // Get or create this network connection
+    NetworkConnection* connection = networkConnectionList->Get(source, dest);
+
+    // Set the bandwidth
+    if (connection->SetBandwidth(bandwidth)) sceneChanged = true;
+}
+    
+
+const std::string* EventParser::String(const char* data) {
+    unsigned int id = BinaryEvent::ReadUInt(data);
+
+    return id < strings.size() ? &strings[id] : NULL;
+}
+
+
+std::string& EventParser::TokenString(const Token& token, int i) {
+    // Reuse the same strings for each line to avoid allocating
+    token.CopyTo(tokenStrings[i]);
+
+    return tokenStrings[i];
+}
\ No newline at end of file
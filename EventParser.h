@@ -0,0 +1,114 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        EventParser.h
+//
+// Author:      David Borland
+//
+// Description: Interface of EventParser class for MatchMaker.  Parses lines of event data,
+//              or binary event records, and applies them to the job, site, workflow, and 
+//              network connection lists.  Job events are held until Flush, so only the net
+//              change to each job is applied.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef EVENTPARSER_H
+#define EVENTPARSER_H
+
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BinaryEvent.h"
+#include "JobList.h"
+#include "NetworkConnectionList.h"
+#include "SiteList.h"
+#include "Tokenizer.h"
+#include "WorkflowList.h"
+
+
+class EventParser {
+public:
+    EventParser(JobList* jobs, SiteList* sites, WorkflowList* workflows, NetworkConnectionList* connections);
+    ~EventParser();
+
+    // Parse complete lines of data.  Returns false if an "EOF" line is found, in which case 
+    // the rest of the data is skipped and the data should be reset.
+    bool Parse(std::string& s);
+
+    // Parse complete binary event records.  Returns false at an end of file record.
+    bool ParseBinary(const std::string& s);
+
+    // Apply the job events parsed since the last flush.  Parsing also flushes before each
+    // site, workflow, or bandwidth event, so they stay in order with the job events.
+    void Flush();
+
+    // Whether any event changed what is drawn, since the flag was last cleared
+    bool GetSceneChanged();
+    void ClearSceneChanged();
+
+private:
+    // These are pointers to the Engine's lists.  They are neither created nor destroyed here.
+    JobList* jobList;
+    SiteList* siteList;
+    WorkflowList* workflowList;
+    NetworkConnectionList* networkConnectionList;
+
+    bool sceneChanged;
+
+    // Changes to a job since the last flush.  Only the last of each kind is kept.
+    struct PendingJob {
+        std::string id;
+
+        bool hasState;
+        std::string state;
+
+        bool hasScience;
+        std::string science;
+
+        bool hasSite;
+        std::string site;
+
+        bool hasWorkflow;
+        std::string workflow;
+
+        bool hasName;
+        std::string name;
+
+        bool hasDataTransfer;
+        std::string dataSourceID;
+        std::string dataSinkID;
+        double dataSize;
+    };
+
+    // Entries past numPendingJobs are kept for reuse
+    std::vector<PendingJob> pendingJobs;
+    int numPendingJobs;
+    std::unordered_map<std::string, int> pendingJobIndex;
+
+    PendingJob& GetPendingJob(const std::string& jobID);
+    void ApplyPendingJob(PendingJob& pending);
+    void ClearPending();
+
+    // Apply events, for both text and binary data
+    void SetJobState(PendingJob& job, const std::string& state, const std::string* science);
+    void StartDataTransfer(PendingJob& job, const std::string& dataSourceID, const std::string& dataSinkID, double dataSize);
+    void SetWorkflow(const std::string& workflowID, const std::string& username, const std::string& workflowName);
+    void SetBandwidth(const std::string& sourceID, const std::string& destID, double bandwidth);
+
+    // Copy a token to a scratch string, for tokens that need to be passed on as strings
+    std::string& TokenString(const Token& token, int i);
+
+    // Scratch strings, one for each token position
+    std::string tokenStrings[Tokenizer::MaxTokens];
+
+    // Strings from binary string records, by number
+    std::vector<std::string> strings;
+
+    // Look up the string numbered at data, or NULL if there isn't one
+    const std::string* String(const char* data);
+};
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        EventQueue.h
+//
+// Author:      David Borland
+//
+// Description: Single-producer/single-consumer lock-free queue for MatchMaker.  Used to hand
+//              data from the socket thread to the graphics thread without locking.  Items
+//              are swapped in and out of the queue, so buffers are recycled rather than copied.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef EVENTQUEUE_H
+#define EVENTQUEUE_H
+
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+
+template <class T>
+class EventQueue {
+public:
+    EventQueue(unsigned int queueCapacity = 1024);
+    ~EventQueue();
+
+    // Only call from the producer thread.  Returns false if the queue is full.
+    // On success, item holds whatever was previously in the slot.
+    bool Push(T& item);
+
+    // Only call from the consumer thread.  Returns false if the queue is empty.
+    bool Pop(T& item);
+
+    bool Empty();
+
+    // Only call from the consumer thread, or when the producer is stopped
+    void Clear();
+
+private:
+    std::vector<T> items;
+    unsigned int mask;
+
+    // Next slot to read, written by the consumer
+    std::atomic<unsigned int> head;
+
+    // Next slot to write, written by the producer
+    std::atomic<unsigned int> tail;
+};
+
+
+template <class T>
+EventQueue<T>::EventQueue(unsigned int queueCapacity) : head(0), tail(0) {
+    // Round up to a power of two so indices can be masked
+    unsigned int capacity = 1;
+    while (capacity < queueCapacity) capacity <<= 1;
+
+    items.resize(capacity);
+    mask = capacity - 1;
+}
+
+
+template <class T>
+EventQueue<T>::~EventQueue() {
+}
+
+
+template <class T>
+bool EventQueue<T>::Push(T& item) {
+    unsigned int t = tail.load(std::memory_order_relaxed);
+
+    // Check for full
+    if (t - head.load(std::memory_order_acquire) > mask) return false;
+
+    std::swap(items[t & mask], item);
+
+    tail.store(t + 1, std::memory_order_release);
+
+    return true;
+}
+
+
+template <class T>
+bool EventQueue<T>::Pop(T& item) {
+    unsigned int h = head.load(std::memory_order_relaxed);
+
+    // Check for empty
+    if (h == tail.load(std::memory_order_acquire)) return false;
+
+    std::swap(item, items[h & mask]);
+
+    head.store(h + 1, std::memory_order_release);
+
+    return true;
+}
+
+
+template <class T>
+bool EventQueue<T>::Empty() {
+    return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+}
+
+
+template <class T>
+void EventQueue<T>::Clear() {
+    head.store(tail.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+
+#endif
\ No newline at end of file
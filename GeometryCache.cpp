@@ -0,0 +1,166 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        GeometryCache.cpp
+//
+// Author:      David Borland
+//
+// Description: Implementation of GeometryCache class for MatchMaker.  Hands out shared mappers
+//              for unit shapes, keyed by shape and resolution.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "GeometryCache.h"
+
+#include <vtkCylinderSource.h>
+#include <vtkDiskSource.h>
+#include <vtkLineSource.h>
+#include <vtkMatrix4x4.h>
+#include <vtkPolyDataAlgorithm.h>
+#include <vtkSphereSource.h>
+#include <vtkTransform.h>
+#include <vtkTransformPolyDataFilter.h>
+
+#include <math.h>
+
+
+std::map<GeometryCache::Key, vtkPolyDataMapper*> GeometryCache::mappers;
+
+
+vtkPolyDataMapper* GeometryCache::GetMapper(Shape shape, int resolution, double innerRadius) {
+    Key key;
+    key.shape = shape;
+    key.resolution = shape == Line ? 1 : resolution;
+    key.innerRadius = shape == Disk ? innerRadius : 0.0;
+
+    std::map<Key, vtkPolyDataMapper*>::iterator it = mappers.find(key);
+    if (it != mappers.end()) return it->second;
+
+    // Create the source for this shape
+    vtkPolyDataAlgorithm* source;
+    switch (shape) {
+        case Disk: {
+            vtkDiskSource* disk = vtkDiskSource::New();
+            disk->SetRadialResolution(1);
+            disk->SetCircumferentialResolution(resolution);
+            disk->SetInnerRadius(key.innerRadius);
+            disk->SetOuterRadius(1.0);
+            source = disk;
+            break;
+        }
+
+        case Cylinder: {
+            vtkCylinderSource* cylinder = vtkCylinderSource::New();
+            cylinder->SetResolution(resolution);
+            cylinder->SetRadius(1.0);
+            cylinder->SetHeight(1.0);
+
+            // Rotate to match the RotateX(90.0) used for cylinder actors
+            vtkTransform* transform = vtkTransform::New();
+            transform->RotateX(90.0);
+
+            vtkTransformPolyDataFilter* rotate = vtkTransformPolyDataFilter::New();
+            rotate->SetInputConnection(cylinder->GetOutputPort());
+            rotate->SetTransform(transform);
+            source = rotate;
+
+            cylinder->Delete();
+            transform->Delete();
+            break;
+        }
+
+        case Sphere: {
+            vtkSphereSource* sphere = vtkSphereSource::New();
+            sphere->SetRadius(1.0);
+            sphere->SetThetaResolution(resolution);
+            source = sphere;
+            break;
+        }
+
+        default: {
+            vtkLineSource* line = vtkLineSource::New();
+            line->SetPoint1(0.0, 0.0, 0.0);
+            line->SetPoint2(1.0, 0.0, 0.0);
+            source = line;
+            break;
+        }
+    }
+
+    vtkPolyDataMapper* mapper = vtkPolyDataMapper::New();
+    mapper->SetInputConnection(source->GetOutputPort());
+    mappers[key] = mapper;
+
+    // The mapper keeps the source
+    source->Delete();
+
+    return mapper;
+}
+
+
+vtkAlgorithmOutput* GeometryCache::GetOutputPort(Shape shape, int resolution, double innerRadius) {
+    return GetMapper(shape, resolution, innerRadius)->GetInputConnection(0, 0);
+}
+
+
+void GeometryCache::SetLine(vtkActor* actor, const Vec3& p1, const Vec3& p2) {
+    vtkMatrix4x4* matrix = actor->GetUserMatrix();
+    if (!matrix) {
+        matrix = vtkMatrix4x4::New();
+        actor->SetUserMatrix(matrix);
+        matrix->Delete();
+    }
+
+    // x goes along the line.  y and z are any unit vectors perpendicular to it, so the
+    // matrix can be inverted.
+    double x[3] = { p2.X() - p1.X(), p2.Y() - p1.Y(), p2.Z() - p1.Z() };
+    double length = sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+
+    double y[3] = { 0.0, 1.0, 0.0 };
+    double z[3] = { 0.0, 0.0, 1.0 };
+    if (length > 0.0) {
+        double d[3] = { x[0] / length, x[1] / length, x[2] / length };
+
+        // Use the axis furthest from the line to find the first perpendicular
+        double axis[3] = { 0.0, 0.0, 0.0 };
+        if (fabs(d[0]) <= fabs(d[1]) && fabs(d[0]) <= fabs(d[2])) axis[0] = 1.0;
+        else if (fabs(d[1]) <= fabs(d[2])) axis[1] = 1.0;
+        else axis[2] = 1.0;
+
+        y[0] = d[1] * axis[2] - d[2] * axis[1];
+        y[1] = d[2] * axis[0] - d[0] * axis[2];
+        y[2] = d[0] * axis[1] - d[1] * axis[0];
+        double yLength = sqrt(y[0] * y[0] + y[1] * y[1] + y[2] * y[2]);
+        y[0] /= yLength;
+        y[1] /= yLength;
+        y[2] /= yLength;
+
+        z[0] = d[1] * y[2] - d[2] * y[1];
+        z[1] = d[2] * y[0] - d[0] * y[2];
+        z[2] = d[0] * y[1] - d[1] * y[0];
+    }
+
+    for (int i = 0; i < 3; i++) {
+        matrix->SetElement(i, 0, x[i]);
+        matrix->SetElement(i, 1, y[i]);
+        matrix->SetElement(i, 2, z[i]);
+    }
+    matrix->SetElement(0, 3, p1.X());
+    matrix->SetElement(1, 3, p1.Y());
+    matrix->SetElement(2, 3, p1.Z());
+}
+
+
+void GeometryCache::Clear() {
+    for (std::map<Key, vtkPolyDataMapper*>::iterator it = mappers.begin(); it != mappers.end(); it++) {
+        it->second->Delete();
+    }
+    mappers.clear();
+}
+
+
+bool GeometryCache::Key::operator<(const Key& other) const {
+    if (shape != other.shape) return shape < other.shape;
+    if (resolution != other.resolution) return resolution < other.resolution;
+
+    return innerRadius < other.innerRadius;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        GeometryCache.h
+//
+// Author:      David Borland
+//
+// Description: Interface of GeometryCache class for MatchMaker.  Hands out shared mappers for
+//              unit shapes, keyed by shape and resolution, so that stacks, sites, and data
+//              transfers don't each run their own source pipeline.  The size and placement
+//              of each copy is set with a transform on its actor.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef GEOMETRYCACHE_H
+#define GEOMETRYCACHE_H
+
+
+#include <vtkActor.h>
+#include <vtkAlgorithmOutput.h>
+#include <vtkPolyDataMapper.h>
+
+#include <map>
+
+#include <Vec3.h>
+
+
+class GeometryCache {
+public:
+    enum Shape {
+        Disk,           // In the xy plane, outer radius 1, inner radius given
+        Cylinder,       // Along z, radius 1, height 1, centered at the origin
+        Sphere,         // Radius 1
+        Line            // From the origin to (1, 0, 0)
+    };
+
+    // Get the shared mapper or output port for a shape.  Actors hold their own reference to
+    // the mapper, so callers don't delete it.
+    static vtkPolyDataMapper* GetMapper(Shape shape, int resolution, double innerRadius = 0.0);
+    static vtkAlgorithmOutput* GetOutputPort(Shape shape, int resolution, double innerRadius = 0.0);
+
+    // Place an actor using the unit line between two points
+    static void SetLine(vtkActor* actor, const Vec3& p1, const Vec3& p2);
+
+    // Give up the cache's references
+    static void Clear();
+
+private:
+    struct Key {
+        Shape shape;
+        int resolution;
+        double innerRadius;
+
+        bool operator<(const Key& other) const;
+    };
+
+    static std::map<Key, vtkPolyDataMapper*> mappers;
+};
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,177 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        GlyphSet.cpp
+//
+// Author:      David Borland
+//
+// Description: Implementation of GlyphSet class for MatchMaker.  Draws many copies of the same
+//              glyph with a single instanced mapper.  Each copy is a row in the point, scale,
+//              and color arrays, so objects hold a row number instead of their own actors.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "GlyphSet.h"
+
+#include <vtkPointData.h>
+#include <vtkProperty.h>
+
+
+GlyphSet::GlyphSet(vtkAlgorithmOutput* glyphSource, vtkRenderer* ren) : renderer(ren) {
+    // Per-glyph arrays
+    points = vtkPoints::New();
+
+    scales = vtkDoubleArray::New();
+    scales->SetName("Scales");
+    scales->SetNumberOfComponents(3);
+
+    colors = vtkUnsignedCharArray::New();
+    colors->SetName("Colors");
+    colors->SetNumberOfComponents(4);
+
+    polyData = vtkPolyData::New();
+    polyData->SetPoints(points);
+    polyData->GetPointData()->AddArray(scales);
+    polyData->GetPointData()->SetScalars(colors);
+
+    // One mapper draws every glyph
+    mapper = vtkGlyph3DMapper::New();
+    mapper->SetInput(polyData);
+    mapper->SetSourceConnection(glyphSource);
+    mapper->SetScaleArray("Scales");
+    mapper->SetScaleModeToScaleByVectorComponents();
+    mapper->ScalingOn();
+    mapper->OrientOff();
+    mapper->SetColorModeToDefault();
+    mapper->SetScalarModeToUsePointData();
+
+    actor = vtkActor::New();
+    actor->SetMapper(mapper);
+    actor->GetProperty()->SetAmbient(0.0);
+    actor->GetProperty()->SetDiffuse(1.0);
+    actor->GetProperty()->SetSpecular(0.0);
+
+    renderer->AddViewProp(actor);
+
+    modified = false;
+}
+
+
+GlyphSet::~GlyphSet() {
+    renderer->RemoveViewProp(actor);
+
+    points->Delete();
+    scales->Delete();
+    colors->Delete();
+    polyData->Delete();
+    mapper->Delete();
+    actor->Delete();
+}
+
+
+int GlyphSet::AddRow() {
+    int row;
+
+    if (freeRows.size() > 0) {
+        row = freeRows.back();
+        freeRows.pop_back();
+    }
+    else {
+        row = points->GetNumberOfPoints();
+
+        points->InsertNextPoint(0.0, 0.0, 0.0);
+        scales->InsertNextTuple3(0.0, 0.0, 0.0);
+        colors->InsertNextTuple4(255, 255, 255, 255);
+
+        rowScales.push_back(1.0);
+        rowScales.push_back(1.0);
+        rowScales.push_back(1.0);
+        rowVisible.push_back(false);
+    }
+
+    // Start with defaults
+    rowScales[row * 3] = rowScales[row * 3 + 1] = rowScales[row * 3 + 2] = 1.0;
+    colors->SetTuple4(row, 255, 255, 255, 255);
+    SetVisible(row, false);
+
+    modified = true;
+
+    return row;
+}
+
+void GlyphSet::RemoveRow(int row) {
+    // Hide it until it is reused
+    SetVisible(row, false);
+
+    freeRows.push_back(row);
+}
+
+
+void GlyphSet::SetPosition(int row, double x, double y, double z) {
+    points->SetPoint(row, x, y, z);
+
+    modified = true;
+}
+
+void GlyphSet::SetScale(int row, double x, double y, double z) {
+    rowScales[row * 3] = x;
+    rowScales[row * 3 + 1] = y;
+    rowScales[row * 3 + 2] = z;
+
+    if (rowVisible[row]) {
+        scales->SetTuple3(row, x, y, z);
+
+        modified = true;
+    }
+}
+
+void GlyphSet::SetColor(int row, double r, double g, double b) {
+    unsigned char* c = colors->GetPointer(row * 4);
+    c[0] = (unsigned char)(r * 255.0 + 0.5);
+    c[1] = (unsigned char)(g * 255.0 + 0.5);
+    c[2] = (unsigned char)(b * 255.0 + 0.5);
+
+    modified = true;
+}
+
+void GlyphSet::SetOpacity(int row, double opacity) {
+    colors->GetPointer(row * 4)[3] = (unsigned char)(opacity * 255.0 + 0.5);
+
+    modified = true;
+}
+
+void GlyphSet::SetVisible(int row, bool visible) {
+    rowVisible[row] = visible;
+
+    // Hidden glyphs are drawn with zero size
+    if (visible) {
+        scales->SetTuple3(row, rowScales[row * 3], rowScales[row * 3 + 1], rowScales[row * 3 + 2]);
+    }
+    else {
+        scales->SetTuple3(row, 0.0, 0.0, 0.0);
+    }
+
+    modified = true;
+}
+
+
+bool GlyphSet::GetVisible(int row) {
+    return rowVisible[row];
+}
+
+
+void GlyphSet::Update() {
+    if (!modified) return;
+
+    points->Modified();
+    scales->Modified();
+    colors->Modified();
+    polyData->Modified();
+
+    modified = false;
+}
+
+
+vtkActor* GlyphSet::GetActor() {
+    return actor;
+}
\ No newline at end of file
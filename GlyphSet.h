@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        GlyphSet.h
+//
+// Author:      David Borland
+//
+// Description: Interface of GlyphSet class for MatchMaker.  Draws many copies of the same
+//              glyph with a single instanced mapper.  Each copy is a row in the point, scale,
+//              and color arrays, so objects hold a row number instead of their own actors.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef GLYPHSET_H
+#define GLYPHSET_H
+
+
+#include <vtkActor.h>
+#include <vtkAlgorithmOutput.h>
+#include <vtkDoubleArray.h>
+#include <vtkGlyph3DMapper.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkRenderer.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <vector>
+
+
+class GlyphSet {
+public:
+    GlyphSet(vtkAlgorithmOutput* glyphSource, vtkRenderer* ren);
+    ~GlyphSet();
+
+    // Get a row for a new glyph, which starts hidden, and give it back when done
+    int AddRow();
+    void RemoveRow(int row);
+
+    // Set properties for a row
+    void SetPosition(int row, double x, double y, double z);
+    void SetScale(int row, double x, double y, double z);
+    void SetColor(int row, double r, double g, double b);
+    void SetOpacity(int row, double opacity);
+    void SetVisible(int row, bool visible);
+
+    bool GetVisible(int row);
+
+    // Push any changes to the mapper.  Call once per frame.
+    void Update();
+
+    vtkActor* GetActor();
+
+private:
+    vtkPoints* points;
+    vtkDoubleArray* scales;
+    vtkUnsignedCharArray* colors;
+    vtkPolyData* polyData;
+    vtkGlyph3DMapper* mapper;
+    vtkActor* actor;
+
+    vtkRenderer* renderer;
+
+    // Scale for each row, kept here so hidden rows can be given a zero scale
+    std::vector<double> rowScales;
+    std::vector<bool> rowVisible;
+
+    // Rows that can be reused
+    std::vector<int> freeRows;
+
+    bool modified;
+};
+
+
+#endif
\ No newline at end of file
@@ -31,142 +31,77 @@ double Job::failedColor[3] =    {1.0, 0.0,  0.0};
 Job::Job(const std::string& jobID, double radius, vtkRenderer* ren, 
          Site* startSite, double height, double jobVelocity, 
          ShowGlyphType showWhichGlyphs, bool showGhostJobs, bool fadeGhostJobs, bool showJobPath, bool showJobTrail, 
-         double labelHeight, bool labelFaceCamera) 
-         : Object(jobID, radius, ren), velocity(jobVelocity), showGhosts(showGhostJobs), fadeGhosts(fadeGhostJobs), showPath(showJobPath), showTrail(showJobTrail) {
+         LabelLayer* labelLayer, bool labelFaceCamera, JobMotion* jobMotion, LineBuffer* lineBuffer, BatchRenderer* batchRenderer) 
+         : Object(jobID, radius, ren), lines(lineBuffer), motion(jobMotion), showGhosts(showGhostJobs), showPath(showJobPath), showTrail(showJobTrail) {
+    // Animation state is a row in the shared job motion arrays
+    motionRow = motion->AddRow(this);
+    motion->SetVelocity(motionRow, jobVelocity);
+    motion->SetFade(motionRow, fadeGhostJobs);
+
     // Set the data transfer
     data = NULL;
 
-    // Create the cylinder representing this job
-    statusGlyph = vtkCylinderSource::New();
-    statusGlyph->SetResolution(resolution);
-    statusGlyph->SetHeight(height);
-    vtkPolyDataMapper* statusGlyphMapper = vtkPolyDataMapper::New();
-    statusGlyphMapper->SetInputConnection(statusGlyph->GetOutputPort());
-    statusActor = vtkActor::New();
-    statusActor->SetMapper(statusGlyphMapper);
-    statusActor->GetProperty()->SetAmbient(0.0);
-    statusActor->GetProperty()->SetDiffuse(1.0);
-    statusActor->GetProperty()->SetSpecular(0.0);
-    statusActor->RotateX(90.0);
-
-    // Create a second cylinder representing this job at its new site
-    ghostStatusGlyph = vtkCylinderSource::New();
-    ghostStatusGlyph->SetResolution(resolution);
-    ghostStatusGlyph->SetHeight(height);
-    vtkPolyDataMapper* ghostStatusGlyphMapper = vtkPolyDataMapper::New();
-    ghostStatusGlyphMapper->SetInputConnection(ghostStatusGlyph->GetOutputPort());
-    ghostStatusActor = vtkActor::New();
-    ghostStatusActor->SetMapper(ghostStatusGlyphMapper);
-    ghostStatusActor->GetProperty()->SetAmbient(0.0);
-    ghostStatusActor->GetProperty()->SetDiffuse(1.0);
-    ghostStatusActor->GetProperty()->SetSpecular(0.0);
-    ghostStatusActor->GetProperty()->SetOpacity(0.0);
-    ghostStatusActor->RotateX(90.0);
-
-    // Create a third cylinder representing this job at its old site
-    oldGhostStatusGlyph = vtkCylinderSource::New();
-    oldGhostStatusGlyph->SetResolution(resolution);
-    oldGhostStatusGlyph->SetHeight(height);
-    vtkPolyDataMapper* oldGhostStatusGlyphMapper = vtkPolyDataMapper::New();
-    oldGhostStatusGlyphMapper->SetInputConnection(oldGhostStatusGlyph->GetOutputPort());
-    oldGhostStatusActor = vtkActor::New();
-    oldGhostStatusActor->SetMapper(oldGhostStatusGlyphMapper);
-    oldGhostStatusActor->GetProperty()->SetAmbient(0.0);
-    oldGhostStatusActor->GetProperty()->SetDiffuse(1.0);
-    oldGhostStatusActor->GetProperty()->SetSpecular(0.0);
-    oldGhostStatusActor->GetProperty()->SetOpacity(0.0);
-    oldGhostStatusActor->RotateX(90.0);
-
-    
-    // Create the representation of the type of science of the job
-    scienceGlyph = vtkCylinderSource::New();
-    scienceGlyph->SetResolution(resolution);
-    scienceGlyph->SetHeight(height * 0.5);
-    vtkPolyDataMapper* scienceGlyphMapper = vtkPolyDataMapper::New();
-    scienceGlyphMapper->SetInputConnection(scienceGlyph->GetOutputPort());
-    scienceActor = vtkActor::New();
-    scienceActor->SetMapper(scienceGlyphMapper);
-    scienceActor->GetProperty()->SetAmbient(0.0);
-    scienceActor->GetProperty()->SetDiffuse(1.0);
-    scienceActor->GetProperty()->SetSpecular(0.0);
-    scienceActor->RotateX(90.0);
-
-    // Create a second cylinder representing the type of science at its new site
-    ghostScienceGlyph = vtkCylinderSource::New();
-    ghostScienceGlyph->SetResolution(resolution);
-    ghostScienceGlyph->SetHeight(height * 0.5);
-    vtkPolyDataMapper* ghostScienceGlyphMapper = vtkPolyDataMapper::New();
-    ghostScienceGlyphMapper->SetInputConnection(ghostScienceGlyph->GetOutputPort());
-    ghostScienceActor = vtkActor::New();
-    ghostScienceActor->SetMapper(ghostScienceGlyphMapper);
-    ghostScienceActor->GetProperty()->SetAmbient(0.0);
-    ghostScienceActor->GetProperty()->SetDiffuse(1.0);
-    ghostScienceActor->GetProperty()->SetSpecular(0.0);
-    ghostScienceActor->GetProperty()->SetOpacity(0.0);
-    ghostScienceActor->RotateX(90.0);
-
-    // Create a third cylinder representing the type of science at its old site
-    oldGhostScienceGlyph = vtkCylinderSource::New();
-    oldGhostScienceGlyph->SetResolution(resolution);
-    oldGhostScienceGlyph->SetHeight(height * 0.5);
-    vtkPolyDataMapper* oldGhostScienceGlyphMapper = vtkPolyDataMapper::New();
-    oldGhostScienceGlyphMapper->SetInputConnection(oldGhostScienceGlyph->GetOutputPort());
-    oldGhostScienceActor = vtkActor::New();
-    oldGhostScienceActor->SetMapper(oldGhostScienceGlyphMapper);
-    oldGhostScienceActor->GetProperty()->SetAmbient(0.0);
-    oldGhostScienceActor->GetProperty()->SetDiffuse(1.0);
-    oldGhostScienceActor->GetProperty()->SetSpecular(0.0);
-    oldGhostScienceActor->GetProperty()->SetOpacity(0.0);
-    oldGhostScienceActor->RotateX(90.0);
-
-
-    // Set the radius for all glyphs
+    // No site until the start site attaches this job
+    site = NULL;
+    oldSite = NULL;
+
+    // No workflow until one inserts this job
+    workflow = NULL;
+    workflowSlot = -1;
+
+    // No path or trail until the job moves
+    pathRow = trailRow = -1;
+
+    // Create the cylinders representing this job: the status and science glyphs, each with a 
+    // ghost at the job's new site and one at its old site
+    batch = batchRenderer;
+    for (int i = 0; i < BatchRenderer::NumJobGlyphs; i++) {
+        if (batch) {
+            glyphs[i] = NULL;
+            glyphActors[i] = NULL;
+            glyphRows[i] = batch->GetJobGlyphs(i)->AddRow();
+        }
+        else {
+            glyphs[i] = vtkCylinderSource::New();
+            glyphs[i]->SetResolution(resolution);
+            vtkPolyDataMapper* glyphMapper = vtkPolyDataMapper::New();
+            glyphMapper->SetInputConnection(glyphs[i]->GetOutputPort());
+            glyphActors[i] = vtkActor::New();
+            glyphActors[i]->SetMapper(glyphMapper);
+            glyphActors[i]->GetProperty()->SetAmbient(0.0);
+            glyphActors[i]->GetProperty()->SetDiffuse(1.0);
+            glyphActors[i]->GetProperty()->SetSpecular(0.0);
+            glyphActors[i]->RotateX(90.0);
+            glyphRows[i] = -1;
+
+            // Don't need this reference any more
+            glyphMapper->Delete();
+        }
+    }
+
+    // Default colors until the state and science are set
+    statusColor[0] = statusColor[1] = statusColor[2] = 1.0;
+    scienceColor[0] = scienceColor[1] = scienceColor[2] = 1.0;
+    SetGlyphColor(BatchRenderer::Science, scienceColor);
+    SetGlyphColor(BatchRenderer::GhostScience, scienceColor);
+    SetGlyphColor(BatchRenderer::OldGhostScience, scienceColor);
+
+    // Ghosts start out invisible
+    SetGlyphOpacity(BatchRenderer::GhostStatus, 0.0);
+    SetGlyphOpacity(BatchRenderer::OldGhostStatus, 0.0);
+    SetGlyphOpacity(BatchRenderer::GhostScience, 0.0);
+    SetGlyphOpacity(BatchRenderer::OldGhostScience, 0.0);
+
+
+    // Set the size for all glyphs
+    glyphHeight = height;
     SetRadius(radius);
 
 
-    // Create the representation of the job's path
-    path = vtkLineSource::New();
-    path->SetResolution(1);
-    vtkPolyDataMapper* pathMapper = vtkPolyDataMapper::New();
-    pathMapper->SetInputConnection(path->GetOutputPort());
-    pathActor = vtkActor::New();
-    pathActor->SetMapper(pathMapper);
-    pathActor->GetProperty()->SetAmbient(0.0);
-    pathActor->GetProperty()->SetDiffuse(1.0);
-    pathActor->GetProperty()->SetSpecular(0.0);
-    pathActor->GetProperty()->SetOpacity(0.75);
-    pathActor->GetProperty()->SetLineWidth(2);
-
-
-    // Create the representation of the job's trail
-    trail = vtkLineSource::New();
-    trail->SetResolution(1);
-    vtkPolyDataMapper* trailMapper = vtkPolyDataMapper::New();
-    trailMapper->SetInputConnection(trail->GetOutputPort());
-    trailActor = vtkActor::New();
-    trailActor->SetMapper(trailMapper);
-    trailActor->GetProperty()->SetAmbient(0.0);
-    trailActor->GetProperty()->SetDiffuse(1.0);
-    trailActor->GetProperty()->SetSpecular(0.0);
-    trailActor->GetProperty()->SetOpacity(0.25);
-    trailActor->GetProperty()->SetLineWidth(2);
-
-
-    // Create text label for the site
+    // Create text label for the job
+    labelRow = -1;
     if (labelFaceCamera) {
-        text = vtkCaptionActor2D::New();
-        text->SetCaption("default");
-        text->GetPositionCoordinate()->SetCoordinateSystemToNormalizedViewport();
-        text->GetPositionCoordinate()->SetValue(0.0, 0.01 - labelHeight);
-        text->SetWidth(1.0);
-        text->SetHeight(labelHeight);
-        text->BorderOff();
-        text->ThreeDimensionalLeaderOff();
-        text->GetCaptionTextProperty()->SetJustificationToLeft();
-        text->GetCaptionTextProperty()->BoldOff();
-        text->GetCaptionTextProperty()->ShadowOff();
-        text->GetCaptionTextProperty()->ItalicOff();
-        text->GetProperty()->SetLineStipplePattern(0x0000);
+        labels = labelLayer;
 
         text3D = NULL;
     }
@@ -178,7 +113,7 @@ Job::Job(const std::string& jobID, double radius, vtkRenderer* ren,
         text3D->GetTextProperty()->ShadowOff();
         text3D->GetTextProperty()->ItalicOff();
 
-        text = NULL;
+        labels = NULL;
     }
     showName = false;
 
@@ -192,31 +127,11 @@ Job::Job(const std::string& jobID, double radius, vtkRenderer* ren,
 
 
     // Set the initial site
-    moving = false;
-    site = NULL;
-    oldSite = NULL;
     startSite->AttachJob(this);
-    statusActor->SetPosition(position.X(), position.Y(), position.Z());
-    scienceActor->SetPosition(position.X(), position.Y(), position.Z());
+    Vec3 position = motion->GetTarget(motionRow);
+    SetCurrentPosition(position);
     SetPosition(position);
     SetOldPosition(position);
-    path->SetPoint1(position.X(), position.Y(), position.Z());
-    path->SetPoint2(position.X(), position.Y(), position.Z());
-    trail->SetPoint1(position.X(), position.Y(), position.Z());
-    trail->SetPoint2(position.X(), position.Y(), position.Z());
-
-
-    // Don't need these references any more
-    statusGlyphMapper->Delete();
-    ghostStatusGlyphMapper->Delete();
-    oldGhostStatusGlyphMapper->Delete();
-
-    scienceGlyphMapper->Delete();
-    ghostScienceGlyphMapper->Delete();
-    oldGhostScienceGlyphMapper->Delete();
-
-    pathMapper->Delete();
-    trailMapper->Delete();
 }
 
 
@@ -225,45 +140,32 @@ Job::~Job() {
     if (oldSite) oldSite->RemoveJob(id);
     site->RemoveJob(id);
 
-    // Remove actors
-    renderer->RemoveViewProp(statusActor);
-    renderer->RemoveViewProp(ghostStatusActor);
-    renderer->RemoveViewProp(oldGhostStatusActor);
+    // Remove glyphs
+    for (int i = 0; i < BatchRenderer::NumJobGlyphs; i++) {
+        if (batch) {
+            batch->GetJobGlyphs(i)->RemoveRow(glyphRows[i]);
+        }
+        else {
+            renderer->RemoveViewProp(glyphActors[i]);
 
-    renderer->RemoveViewProp(scienceActor);
-    renderer->RemoveViewProp(ghostScienceActor);
-    renderer->RemoveViewProp(oldGhostScienceActor);
+            glyphs[i]->Delete();
+            glyphActors[i]->Delete();
+        }
+    }
 
-    renderer->RemoveViewProp(pathActor);
-    renderer->RemoveViewProp(trailActor);
+    // Remove path and trail
+    RemoveLines();
 
-    if (text) renderer->RemoveViewProp(text);
+    // Remove the label
+    if (labelRow >= 0) labels->RemoveRow(labelRow);
     if (text3D) renderer->RemoveViewProp(text3D);
 
     // Clean up
-    statusGlyph->Delete();
-    statusActor->Delete();
-    ghostStatusGlyph->Delete();
-    ghostStatusActor->Delete();
-    oldGhostStatusGlyph->Delete();
-    oldGhostStatusActor->Delete();
-
-    scienceGlyph->Delete();
-    scienceActor->Delete();
-    ghostScienceGlyph->Delete();
-    ghostScienceActor->Delete();
-    oldGhostScienceGlyph->Delete();
-    oldGhostScienceActor->Delete();
-
-    path->Delete();
-    pathActor->Delete();
-    trail->Delete();
-    trailActor->Delete();
-
-    if (text) text->Delete();
     if (text3D) text3D->Delete();
 
     if (data) delete data;
+
+    motion->RemoveRow(motionRow);
 }
 
 
@@ -272,39 +174,56 @@ Site* Job::GetSite() {
 }
 
 
+bool Job::IsValidState(const std::string& state) {
+    return state == "MATCHING" || state == "SUBMITTING" || state == "QUEUED" ||
+           state == "RUNNING" || state == "DONE" || state == "FAILED";
+}
+
+
 bool Job::SetState(const std::string& state) {
     isDone = false;
 
     // Set the color based on the state
     if (state == "MATCHING") {
         SetColor(matchingColor[0], matchingColor[1], matchingColor[2]);
+        this->state = Matching;
     }
     else if (state == "SUBMITTING") {
         SetColor(submittingColor[0], submittingColor[1], submittingColor[2]);
+        this->state = Submitting;
     }
     else if (state == "QUEUED") {
         SetColor(queuedColor[0], queuedColor[1], queuedColor[2]);
+        this->state = Queued;
     }
     else if (state == "RUNNING") {
         SetColor(runningColor[0], runningColor[1], runningColor[2]);
+        this->state = Running;
     }
     else if (state == "DONE") {
         SetColor(doneColor[0], doneColor[1], doneColor[2]);
+        this->state = Done;
         isDone = true;
     }
     else if (state == "FAILED") {
         SetColor(failedColor[0], failedColor[1], failedColor[2]);
+        this->state = Failed;
     }
     else {
         // Don't know this state
         return false;
     }
 
+    // The site's bars count jobs by state
+    if (site) site->JobChanged(id);
+
     // If not matching and there is a data transfer, stop the data transfer
     if (state != "MATCHING") {
         if (data) {
             delete data;
             data = NULL;
+
+            motion->SetTransferring(motionRow, false);
         }
     }
 
@@ -319,45 +238,45 @@ void Job::SetSite(Site* newSite) {
     oldSite = site;
     site = newSite;
 
-    moving = true;
-    SetOldPosition(position);
+    // The job no longer counts at the site it is leaving
+    if (oldSite) oldSite->JobChanged(id);
+
+    motion->SetMoving(motionRow, true);
+    SetOldPosition(motion->GetTarget(motionRow));
 
-    // Add these actors to the renderer
+    // Show the ghosts
     if (showGhosts) {
         if (showGlyphs == ShowStatusOnly) {
-            renderer->AddViewProp(ghostStatusActor);
-            renderer->AddViewProp(oldGhostStatusActor);
+            ShowGlyph(BatchRenderer::GhostStatus, true);
+            ShowGlyph(BatchRenderer::OldGhostStatus, true);
         }
         else if (showGlyphs == ShowScienceOnly) {
-            renderer->AddViewProp(ghostScienceActor);
-            renderer->AddViewProp(oldGhostScienceActor);
+            ShowGlyph(BatchRenderer::GhostScience, true);
+            ShowGlyph(BatchRenderer::OldGhostScience, true);
         }
         else if (showGlyphs == ShowStatusAndScience) {
-            renderer->AddViewProp(ghostScienceActor);
-            renderer->AddViewProp(oldGhostScienceActor);
+            ShowGlyph(BatchRenderer::GhostScience, true);
+            ShowGlyph(BatchRenderer::OldGhostScience, true);
 
-            renderer->AddViewProp(ghostStatusActor);
-            renderer->AddViewProp(oldGhostStatusActor);
+            ShowGlyph(BatchRenderer::GhostStatus, true);
+            ShowGlyph(BatchRenderer::OldGhostStatus, true);
         }
     }
-    if (showPath) {
-        renderer->AddViewProp(pathActor);
-    }
-    if (showTrail) {
-        renderer->AddViewProp(trailActor);
-    }
+    // Show the path and trail
+    CreateLines();
 }
 
 
 void Job::SetScienceColor(double r, double g, double b) {
-    scienceActor->GetProperty()->SetColor(r, g, b);
-    ghostScienceActor->GetProperty()->SetColor(r, g, b);
-    oldGhostScienceActor->GetProperty()->SetColor(r, g, b);
+    scienceColor[0] = r;
+    scienceColor[1] = g;
+    scienceColor[2] = b;
 
-    if (showGlyphs == ShowScienceOnly) {
-        pathActor->GetProperty()->SetColor(r, g, b);
-        trailActor->GetProperty()->SetColor(r, g, b);
-    }
+    SetGlyphColor(BatchRenderer::Science, scienceColor);
+    SetGlyphColor(BatchRenderer::GhostScience, scienceColor);
+    SetGlyphColor(BatchRenderer::OldGhostScience, scienceColor);
+
+    if (showGlyphs == ShowScienceOnly) UpdateLineColors();
 }
 
 
@@ -365,74 +284,66 @@ void Job::StartDataTransfer(Site* dataSource, Site* dataSink, NetworkConnection*
     // Make sure there's not already a data transfer.  If so, kill it.
     if (data) delete data;
 
-    data = new DataTransfer(dataSource, dataSink, connection, this, dataSize, renderer);
-    data->SetOpacity(statusActor->GetProperty()->GetOpacity());
+    data = new DataTransfer(dataSource, dataSink, connection, this, dataSize, renderer, batch);
+    data->SetOpacity(motion->GetOpacity(motionRow));
+
+    motion->SetTransferring(motionRow, true);
 }
 
 
 double Job::GetRadius() {
-    return statusGlyph->GetRadius();
+    return glyphRadius;
 }
 
 const double* Job::GetColor() {
-    return statusActor->GetProperty()->GetColor();
+    return statusColor;
 }
 
 void Job::SetRadius(double radius) {
-    statusGlyph->SetRadius(radius);
-    ghostStatusGlyph->SetRadius(radius);
-    oldGhostStatusGlyph->SetRadius(radius);
+    glyphRadius = radius;
 
-    scienceGlyph->SetRadius(radius * 1.25);
-    ghostScienceGlyph->SetRadius(radius * 1.25);
-    oldGhostScienceGlyph->SetRadius(radius * 1.25);
+    UpdateGlyphSizes();
 }
 
 void Job::SetColor(double r, double g, double b) {
-    statusActor->GetProperty()->SetColor(r, g, b);
-    ghostStatusActor->GetProperty()->SetColor(r, g, b);
-    oldGhostStatusActor->GetProperty()->SetColor(r, g, b);
+    statusColor[0] = r;
+    statusColor[1] = g;
+    statusColor[2] = b;
 
-    if (showGlyphs != ShowScienceOnly) {
-        pathActor->GetProperty()->SetColor(r, g, b);
-        trailActor->GetProperty()->SetColor(r, g, b);
-    }
+    SetGlyphColor(BatchRenderer::Status, statusColor);
+    SetGlyphColor(BatchRenderer::GhostStatus, statusColor);
+    SetGlyphColor(BatchRenderer::OldGhostStatus, statusColor);
 
-    double colorScale = matchingColor[0] < 1.0 ? 0.0 : -0.75;
+    if (showGlyphs != ShowScienceOnly) UpdateLineColors();
 
-    if (text) text->GetProperty()->SetColor(r + colorScale < 0.0 ? 0.0 : r + colorScale, 
-                                            g + colorScale < 0.0 ? 0.0 : g + colorScale,
-                                            b + colorScale < 0.0 ? 0.0 : b + colorScale);
-    if (text3D) text3D->GetTextProperty()->SetColor(r + colorScale < 0.0 ? 0.0 : r + colorScale, 
-                                                    g + colorScale < 0.0 ? 0.0 : g + colorScale,
-                                                    b + colorScale < 0.0 ? 0.0 : b + colorScale);
+    UpdateLabelColor();
 }
 
-void Job::SetOpacity(double opacity) {
-    statusActor->GetProperty()->SetOpacity(opacity);
-    scienceActor->GetProperty()->SetOpacity(opacity);
+void Job::SetOpacity(double jobOpacity) {
+    motion->SetOpacity(motionRow, jobOpacity);
 
-    // Ghost actor opacities get set in UpdatePosition()
+    SetGlyphOpacity(BatchRenderer::Status, jobOpacity);
+    SetGlyphOpacity(BatchRenderer::Science, jobOpacity);
 
-    pathActor->GetProperty()->SetOpacity(opacity * 0.75);
-    trailActor->GetProperty()->SetOpacity(opacity * 0.25);
+    // Ghost actor opacities get set in UpdateMotion()
+
+    if (pathRow >= 0) {
+        lines->SetOpacity(pathRow, jobOpacity * 0.75);
+        lines->SetOpacity(trailRow, jobOpacity * 0.25);
+    }
 
-    if (data) data->SetOpacity(opacity);
+    if (data) data->SetOpacity(jobOpacity);
 }
 
 
 double Job::GetHeight() {
-    return statusGlyph->GetHeight();
+    return glyphHeight;
 }
 
 void Job::SetHeight(double height) {
-    statusGlyph->SetHeight(height);
-    ghostStatusGlyph->SetHeight(height);
-    oldGhostStatusGlyph->SetHeight(height);
+    glyphHeight = height;
 
-    scienceGlyph->SetHeight(height * 0.5);
-    ghostScienceGlyph->SetHeight(height * 0.5);
-    oldGhostScienceGlyph->SetHeight(height * 0.5);
+    UpdateGlyphSizes();
 }
 
 
@@ -443,113 +354,120 @@ const std::string& Job::GetName() {
 void Job::SetName(const std::string& jobName) {
     name = jobName;
 
-    // Set the caption text
-    if (text) text->SetCaption(name.c_str());
+    // Set the label text
+    if (labelRow >= 0) labels->SetText(labelRow, name);
     if (text3D) text3D->SetInput(name.c_str());
 
     ShowName(showName);
 }
 
 
+Workflow* Job::GetWorkflow() {
+    return workflow;
+}
+
+int Job::GetWorkflowSlot() {
+    return workflowSlot;
+}
+
+void Job::SetWorkflow(Workflow* jobWorkflow, int slot) {
+    workflow = jobWorkflow;
+    workflowSlot = slot;
+}
+
+
 bool Job::IsDone() {
     return isDone;
 }
 
+bool Job::IsMoving() {
+    return motion->GetMoving(motionRow);
+}
+
+
+Job::StateType Job::GetState() {
+    return state;
+}
+
+const double* Job::GetStateColor(StateType state) {
+    switch (state) {
+        case Matching:      return matchingColor;
+        case Submitting:    return submittingColor;
+        case Queued:        return queuedColor;
+        case Running:       return runningColor;
+        case Done:          return doneColor;
+        default:            return failedColor;
+    }
+}
+
 
 void Job::ShowGlyphs(ShowGlyphType show) {
     showGlyphs = show;
 
     if (showGlyphs == ShowStatusOnly) {
-        renderer->AddViewProp(statusActor);
-        renderer->RemoveViewProp(scienceActor);
+        ShowGlyph(BatchRenderer::Status, true);
+        ShowGlyph(BatchRenderer::Science, false);
 
-        if (moving) {            
-            renderer->AddViewProp(ghostStatusActor);
-            renderer->AddViewProp(oldGhostStatusActor);
+        if (motion->GetMoving(motionRow)) {            
+            ShowGlyph(BatchRenderer::GhostStatus, true);
+            ShowGlyph(BatchRenderer::OldGhostStatus, true);
 
-            renderer->RemoveViewProp(ghostScienceActor);
-            renderer->RemoveViewProp(oldGhostScienceActor);
+            ShowGlyph(BatchRenderer::GhostScience, false);
+            ShowGlyph(BatchRenderer::OldGhostScience, false);
         }
 
-        pathActor->GetProperty()->SetColor(statusActor->GetProperty()->GetColor());
-        trailActor->GetProperty()->SetColor(statusActor->GetProperty()->GetColor());
     }
     else if (showGlyphs == ShowScienceOnly) {
-        renderer->RemoveViewProp(statusActor);
-        renderer->AddViewProp(scienceActor);
+        ShowGlyph(BatchRenderer::Status, false);
+        ShowGlyph(BatchRenderer::Science, true);
 
-        if (moving) {
-            renderer->RemoveViewProp(ghostStatusActor);
-            renderer->RemoveViewProp(oldGhostStatusActor);
+        if (motion->GetMoving(motionRow)) {
+            ShowGlyph(BatchRenderer::GhostStatus, false);
+            ShowGlyph(BatchRenderer::OldGhostStatus, false);
 
-            renderer->AddViewProp(ghostScienceActor);
-            renderer->AddViewProp(oldGhostScienceActor);
+            ShowGlyph(BatchRenderer::GhostScience, true);
+            ShowGlyph(BatchRenderer::OldGhostScience, true);
         }
 
-        pathActor->GetProperty()->SetColor(scienceActor->GetProperty()->GetColor());
-        trailActor->GetProperty()->SetColor(scienceActor->GetProperty()->GetColor());
     }
     else if (showGlyphs == ShowStatusAndScience) {
-        renderer->AddViewProp(statusActor);
-        renderer->AddViewProp(scienceActor);
+        ShowGlyph(BatchRenderer::Status, true);
+        ShowGlyph(BatchRenderer::Science, true);
 
-    if (moving) {
-            renderer->AddViewProp(ghostScienceActor);
-            renderer->AddViewProp(oldGhostScienceActor);
+        if (motion->GetMoving(motionRow)) {
+            ShowGlyph(BatchRenderer::GhostScience, true);
+            ShowGlyph(BatchRenderer::OldGhostScience, true);
 
-            renderer->AddViewProp(ghostStatusActor);
-            renderer->AddViewProp(oldGhostStatusActor);
+            ShowGlyph(BatchRenderer::GhostStatus, true);
+            ShowGlyph(BatchRenderer::OldGhostStatus, true);
         }
-
-        pathActor->GetProperty()->SetColor(statusActor->GetProperty()->GetColor());
-        trailActor->GetProperty()->SetColor(statusActor->GetProperty()->GetColor());
     }
+
+    UpdateLineColors();
 }
 
 
-void Job::UpdatePosition() {
+bool Job::UpdateMotion(int numSteps) {
     // Update any data transfer
-    if (data) data->Update();
-
+    bool changed = data && data->Update(numSteps);
 
-    if (!moving) {
-        // Make sure we are in the correct place
-        statusActor->SetPosition(position.X(), position.Y(), position.Z());
-        oldGhostStatusActor->SetPosition(position.X(), position.Y(), position.Z());
-        scienceActor->SetPosition(position.X(), position.Y(), position.Z());
-        oldGhostScienceActor->SetPosition(position.X(), position.Y(), position.Z());
+    Vec3 currentPosition = motion->GetCurrent(motionRow);
+    Vec3 position = motion->GetTarget(motionRow);
+    Vec3 oldPosition = motion->GetStart(motionRow);
 
-        path->SetPoint1(position.X(), position.Y(), position.Z());
-        path->SetPoint2(position.X(), position.Y(), position.Z());
-        trail->SetPoint1(position.X(), position.Y(), position.Z());
-        trail->SetPoint2(position.X(), position.Y(), position.Z());
-
-        return;
-    }
-
-
-    // Get the current position
-    Vec3 actorPos(statusActor->GetPosition()[0], statusActor->GetPosition()[1], statusActor->GetPosition()[2]);
-    Vec3 diff = position - actorPos;
-    double dist = diff.Magnitude();
-
-    if (dist <= velocity) {
-        // If close enough, set to end position
-        statusActor->SetPosition(position.X(), position.Y(), position.Z());
-        oldGhostStatusActor->SetPosition(position.X(), position.Y(), position.Z());
-        scienceActor->SetPosition(position.X(), position.Y(), position.Z());        
-        oldGhostScienceActor->SetPosition(position.X(), position.Y(), position.Z());
-
-        path->SetPoint1(position.X(), position.Y(), position.Z());
-        trail->SetPoint1(position.X(), position.Y(), position.Z());
+    if (motion->GetArrived(motionRow)) {
+        // Set to end position
+        SetGlyphPosition(BatchRenderer::Status, position);
+        SetGlyphPosition(BatchRenderer::Science, position);
+        SetGlyphPosition(BatchRenderer::OldGhostStatus, position);
+        SetGlyphPosition(BatchRenderer::OldGhostScience, position);
 
         // Don't need these any more
-        renderer->RemoveViewProp(ghostStatusActor);
-        renderer->RemoveViewProp(oldGhostStatusActor);
-        renderer->RemoveViewProp(ghostScienceActor);
-        renderer->RemoveViewProp(oldGhostScienceActor);
-        renderer->RemoveViewProp(pathActor);
-        renderer->RemoveViewProp(trailActor);
+        ShowGlyph(BatchRenderer::GhostStatus, false);
+        ShowGlyph(BatchRenderer::OldGhostStatus, false);
+        ShowGlyph(BatchRenderer::GhostScience, false);
+        ShowGlyph(BatchRenderer::OldGhostScience, false);
+        RemoveLines();
 
         // Remove from old site
         if (oldSite) {
@@ -557,97 +475,76 @@ void Job::UpdatePosition() {
             oldSite = NULL;
         }
 
-        // Done moving
-        moving = false;
+        changed = true;
     }
-    else {
-        // Get the total distance
-        Vec3 totalDiff = oldPosition - position;
-        double totalDist = totalDiff.Magnitude();
-
-        // Normalize the direction vector
-        Vec3 norm = diff;
-        norm.Normalize();
-
-        // Scale 
-        Vec3 offset = norm;
-        offset *= velocity;
-
+    else if (motion->GetMoving(motionRow)) {
         // Move
-        statusActor->AddPosition(offset.X(), offset.Y(), offset.Z());
-        scienceActor->SetPosition(statusActor->GetPosition());
-
-        // Update ghost opacities
-        double maxOpacity = statusActor->GetProperty()->GetOpacity();
-        if (fadeGhosts) {
-            double frac = dist / totalDist;
-            
-            double minOpacity = maxOpacity * 0.25;
-            double ghostOpacity = (maxOpacity - frac) * (maxOpacity - minOpacity) + minOpacity;
-            double oldGhostOpacity = frac * (maxOpacity - minOpacity) + minOpacity;
-            ghostStatusActor->GetProperty()->SetOpacity(ghostOpacity);
-            oldGhostStatusActor->GetProperty()->SetOpacity(oldGhostOpacity);
-            ghostScienceActor->GetProperty()->SetOpacity(ghostOpacity);
-            oldGhostScienceActor->GetProperty()->SetOpacity(oldGhostOpacity);
-        }
-        else {                
-            ghostStatusActor->GetProperty()->SetOpacity(maxOpacity * 0.5);
-            oldGhostStatusActor->GetProperty()->SetOpacity(maxOpacity * 0.5);
-            ghostScienceActor->GetProperty()->SetOpacity(maxOpacity * 0.5);
-            oldGhostScienceActor->GetProperty()->SetOpacity(maxOpacity * 0.5);
-        }
+        SetGlyphPosition(BatchRenderer::Status, currentPosition);
+        SetGlyphPosition(BatchRenderer::Science, currentPosition);
+
+        // Ghost opacities were worked out with the step
+        double ghostOpacity = motion->GetGhostOpacity(motionRow);
+        double oldGhostOpacity = motion->GetOldGhostOpacity(motionRow);
+        SetGlyphOpacity(BatchRenderer::GhostStatus, ghostOpacity);
+        SetGlyphOpacity(BatchRenderer::OldGhostStatus, oldGhostOpacity);
+        SetGlyphOpacity(BatchRenderer::GhostScience, ghostOpacity);
+        SetGlyphOpacity(BatchRenderer::OldGhostScience, oldGhostOpacity);
 
         // Update path
-        double radius = statusGlyph->GetRadius();
-        norm = diff;
+        double radius = glyphRadius;
+        Vec3 norm = position - currentPosition;
         norm.Z() = 0.0;
         norm.Normalize();
         norm *= radius;
-        path->SetPoint1(statusActor->GetPosition()[0] + norm.X(),            
-                        statusActor->GetPosition()[1] + norm.Y(),
-                        statusActor->GetPosition()[2]);
-        path->SetPoint2(position.X() - norm.X(),
-                        position.Y() - norm.Y(),
-                        position.Z());
-
-        norm.Set(actorPos.X() - oldPosition.X(), actorPos.Y() - oldPosition.Y(), 0.0);
+        lines->SetLine(pathRow, 
+                       Vec3(currentPosition.X() + norm.X(), currentPosition.Y() + norm.Y(), currentPosition.Z()),
+                       Vec3(position.X() - norm.X(), position.Y() - norm.Y(), position.Z()));
+
+        norm.Set(currentPosition.X() - oldPosition.X(), currentPosition.Y() - oldPosition.Y(), 0.0);
         norm.Normalize();
         norm *= radius;
-        trail->SetPoint1(oldPosition.X() + norm.X(),
-                         oldPosition.Y() + norm.Y(),
-                         oldPosition.Z());
-        trail->SetPoint2(statusActor->GetPosition()[0] - norm.X(),
-                         statusActor->GetPosition()[1] - norm.Y(),
-                         statusActor->GetPosition()[2]);
+        lines->SetLine(trailRow, 
+                       Vec3(oldPosition.X() + norm.X(), oldPosition.Y() + norm.Y(), oldPosition.Z()),
+                       Vec3(currentPosition.X() - norm.X(), currentPosition.Y() - norm.Y(), currentPosition.Z()));
+
+        changed = true;
     }
+
+    return changed;
 }
 
 
-const Vec3& Job::GetPosition() {
-    return position;
+Vec3 Job::GetPosition() {
+    return motion->GetTarget(motionRow);
 }
 
 void Job::SetPosition(const Vec3& pos) {
-    position = pos;
+    motion->SetTarget(motionRow, pos);
 
-    ghostStatusActor->SetPosition(position.X(), position.Y(), position.Z());
-    ghostScienceActor->SetPosition(position.X(), position.Y(), position.Z());
+    SetGlyphPosition(BatchRenderer::GhostStatus, pos);
+    SetGlyphPosition(BatchRenderer::GhostScience, pos);
+
+    // A job that isn't moving goes straight there, as the step leaves it alone
+    if (!motion->GetMoving(motionRow)) {
+        SetCurrentPosition(pos);
+        SetGlyphPosition(BatchRenderer::OldGhostStatus, pos);
+        SetGlyphPosition(BatchRenderer::OldGhostScience, pos);
+    }
 
     // Set the attachment point for the text
-    if (text) text->SetAttachmentPoint(position.X() + statusGlyph->GetRadius(), position.Y(), position.Z());
-    if (text3D) text3D->SetPosition(position.X() + statusGlyph->GetRadius(), position.Y(), position.Z());
+    UpdateLabelPosition();
 }
 
 
 void Job::SetOldPosition(const Vec3& pos) {
-    oldPosition = pos; 
-    oldGhostStatusActor->SetPosition(oldPosition.X(), oldPosition.Y(), oldPosition.Z());
-    oldGhostScienceActor->SetPosition(oldPosition.X(), oldPosition.Y(), oldPosition.Z());
+    motion->SetStart(motionRow, pos);
+    SetGlyphPosition(BatchRenderer::OldGhostStatus, pos);
+    SetGlyphPosition(BatchRenderer::OldGhostScience, pos);
 }
 
 
 void Job::SetVelocity(double v) {
-    velocity = v;
+    motion->SetVelocity(motionRow, v);
 }
 
 
@@ -655,85 +552,107 @@ void Job::ShowGhost(bool show) {
     showGhosts = show;
 
     if (showGhosts) {
-        if (moving) {
+        if (motion->GetMoving(motionRow)) {
             if (showGlyphs == ShowStatusOnly) {
-                renderer->AddViewProp(ghostStatusActor);
-                renderer->AddViewProp(oldGhostStatusActor);
+                ShowGlyph(BatchRenderer::GhostStatus, true);
+                ShowGlyph(BatchRenderer::OldGhostStatus, true);
             }
             else if (showGlyphs == ShowScienceOnly) {
-                renderer->AddViewProp(ghostScienceActor);
-                renderer->AddViewProp(oldGhostScienceActor);
+                ShowGlyph(BatchRenderer::GhostScience, true);
+                ShowGlyph(BatchRenderer::OldGhostScience, true);
             }   
             else {                
-                renderer->AddViewProp(ghostStatusActor);
-                renderer->AddViewProp(oldGhostStatusActor);
+                ShowGlyph(BatchRenderer::GhostStatus, true);
+                ShowGlyph(BatchRenderer::OldGhostStatus, true);
 
-                renderer->AddViewProp(ghostScienceActor);
-                renderer->AddViewProp(oldGhostScienceActor);
+                ShowGlyph(BatchRenderer::GhostScience, true);
+                ShowGlyph(BatchRenderer::OldGhostScience, true);
             }
         }
     }
     else {
-        renderer->RemoveViewProp(ghostStatusActor);
-        renderer->RemoveViewProp(oldGhostStatusActor);
+        ShowGlyph(BatchRenderer::GhostStatus, false);
+        ShowGlyph(BatchRenderer::OldGhostStatus, false);
 
-        renderer->RemoveViewProp(ghostScienceActor);
-        renderer->RemoveViewProp(oldGhostScienceActor);
+        ShowGlyph(BatchRenderer::GhostScience, false);
+        ShowGlyph(BatchRenderer::OldGhostScience, false);
     }
 }
 
 
 void Job::FadeGhost(bool fade) {
-    fadeGhosts = fade;
+    motion->SetFade(motionRow, fade);
 }
 
 
 void Job::ShowPath(bool show) {
     showPath = show;
 
-    if (showPath) {
-        if (moving) {
-            renderer->AddViewProp(pathActor);
-        }
-    }
-    else {
-        renderer->RemoveViewProp(pathActor);
-    }
+    if (pathRow >= 0) lines->SetVisible(pathRow, showPath);
 }
 
 
 void Job::ShowTrail(bool show) {
     showTrail = show;
 
-    if (showTrail) {
-        if (moving) {
-            renderer->AddViewProp(trailActor);
-        }
-    }
-    else {
-        renderer->RemoveViewProp(trailActor);
-    }
+    if (trailRow >= 0) lines->SetVisible(trailRow, showTrail);
 }
 
 
 void Job::ShowName(bool show) {
     showName = show;
 
-    if (showName) {
-        // Add the actor to the renderer
-        if (name.size() > 0) {
-            if (text) renderer->AddViewProp(text);
-            if (text3D) renderer->AddViewProp(text3D);
+    if (showName && name.size() > 0) {
+        // Add the label
+        if (labels && labelRow < 0) {
+            labelRow = labels->AddRow();
+            labels->SetText(labelRow, name);
+            labels->SetVisible(labelRow, true);
+
+            UpdateLabelColor();
+            UpdateLabelPosition();
         }
+        if (text3D) renderer->AddViewProp(text3D);
     }
     else {
-        // Remove the actor from the renderer
-        if (text) renderer->RemoveViewProp(text);
+        // Remove the label
+        if (labelRow >= 0) {
+            labels->RemoveRow(labelRow);
+            labelRow = -1;
+        }
         if (text3D) renderer->RemoveViewProp(text3D);
     }
 }
 
 
+void Job::ShowDetail(bool show) {
+    if (batch) return;
+
+    for (int i = 0; i < BatchRenderer::NumJobGlyphs; i++) {
+        glyphActors[i]->SetVisibility(show);
+    }
+}
+
+
+void Job::UpdateLabelColor() {
+    double colorScale = matchingColor[0] < 1.0 ? 0.0 : -0.75;
+
+    double r = statusColor[0] + colorScale < 0.0 ? 0.0 : statusColor[0] + colorScale;
+    double g = statusColor[1] + colorScale < 0.0 ? 0.0 : statusColor[1] + colorScale;
+    double b = statusColor[2] + colorScale < 0.0 ? 0.0 : statusColor[2] + colorScale;
+
+    if (labelRow >= 0) labels->SetColor(labelRow, r, g, b);
+    if (text3D) text3D->GetTextProperty()->SetColor(r, g, b);
+}
+
+void Job::UpdateLabelPosition() {
+    Vec3 position = motion->GetTarget(motionRow);
+
+    if (labelRow >= 0) labels->SetPosition(labelRow, position.X() + glyphRadius, position.Y(), position.Z());
+    if (text3D) text3D->SetPosition(position.X() + glyphRadius, position.Y(), position.Z());
+}
+
+
 void Job::ScaleColor(double scale) {    
     for (int i = 0; i < 3; i++) {
         matchingColor[i] *= scale;
@@ -743,4 +662,106 @@ void Job::ScaleColor(double scale) {
         doneColor[i] *= scale;
         failedColor[i] *= scale;
     }
+}
+
+
+void Job::ShowGlyph(int glyph, bool show) {
+    if (batch) {
+        batch->GetJobGlyphs(glyph)->SetVisible(glyphRows[glyph], show);
+    }
+    else {
+        if (show) renderer->AddViewProp(glyphActors[glyph]);
+        else renderer->RemoveViewProp(glyphActors[glyph]);
+    }
+}
+
+void Job::SetGlyphPosition(int glyph, const Vec3& pos) {
+    if (batch) {
+        batch->GetJobGlyphs(glyph)->SetPosition(glyphRows[glyph], pos.X(), pos.Y(), pos.Z());
+    }
+    else {
+        glyphActors[glyph]->SetPosition(pos.X(), pos.Y(), pos.Z());
+    }
+}
+
+void Job::SetGlyphColor(int glyph, const double* color) {
+    if (batch) {
+        batch->GetJobGlyphs(glyph)->SetColor(glyphRows[glyph], color[0], color[1], color[2]);
+    }
+    else {
+        glyphActors[glyph]->GetProperty()->SetColor(color[0], color[1], color[2]);
+    }
+}
+
+void Job::SetGlyphOpacity(int glyph, double glyphOpacity) {
+    if (batch) {
+        batch->GetJobGlyphs(glyph)->SetOpacity(glyphRows[glyph], glyphOpacity);
+    }
+    else {
+        glyphActors[glyph]->GetProperty()->SetOpacity(glyphOpacity);
+    }
+}
+
+void Job::UpdateGlyphSizes() {
+    for (int i = 0; i < BatchRenderer::NumJobGlyphs; i++) {
+        // Science glyphs are wider and shorter than status glyphs
+        bool science = i == BatchRenderer::Science || 
+                       i == BatchRenderer::GhostScience || 
+                       i == BatchRenderer::OldGhostScience;
+
+        double radius = science ? glyphRadius * 1.25 : glyphRadius;
+        double height = science ? glyphHeight * 0.5 : glyphHeight;
+
+        if (batch) {
+            // The glyph set cylinder has unit radius and height, along z
+            batch->GetJobGlyphs(i)->SetScale(glyphRows[i], radius, radius, height);
+        }
+        else {
+            glyphs[i]->SetRadius(radius);
+            glyphs[i]->SetHeight(height);
+        }
+    }
+}
+
+
+void Job::CreateLines() {
+    if (pathRow < 0) {
+        pathRow = lines->AddRow();
+        trailRow = lines->AddRow();
+
+        double opacity = motion->GetOpacity(motionRow);
+        lines->SetOpacity(pathRow, opacity * 0.75);
+        lines->SetOpacity(trailRow, opacity * 0.25);
+
+        UpdateLineColors();
+    }
+
+    lines->SetVisible(pathRow, showPath);
+    lines->SetVisible(trailRow, showTrail);
+}
+
+void Job::RemoveLines() {
+    if (pathRow < 0) return;
+
+    lines->RemoveRow(pathRow);
+    lines->RemoveRow(trailRow);
+
+    pathRow = trailRow = -1;
+}
+
+void Job::UpdateLineColors() {
+    if (pathRow < 0) return;
+
+    const double* color = showGlyphs == ShowScienceOnly ? scienceColor : statusColor;
+
+    lines->SetColor(pathRow, color[0], color[1], color[2]);
+    lines->SetColor(trailRow, color[0], color[1], color[2]);
+}
+
+
+void Job::SetCurrentPosition(const Vec3& pos) {
+    motion->SetCurrent(motionRow, pos);
+
+    SetGlyphPosition(BatchRenderer::Status, pos);
+    SetGlyphPosition(BatchRenderer::Science, pos);
 }
\ No newline at end of file
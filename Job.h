@@ -19,13 +19,15 @@
 
 #include <vtkActor.h>
 #include <vtkCubeSource.h>
-#include <vtkCaptionActor2D.h>
 #include <vtkCylinderSource.h>
-#include <vtkLineSource.h>
 #include <vtkTextActor3D.h>
 
 #include <Vec3.h>
 
+#include "BatchRenderer.h"
+#include "JobMotion.h"
+#include "LabelLayer.h"
+#include "LineBuffer.h"
 #include "Site.h"
 #include "DataTransfer.h"
 #include "NetworkConnection.h"
@@ -34,6 +36,7 @@
 class DataTransfer;
 class NetworkConnection;
 class Site;
+class Workflow;
 
 
 class Job : public Object {
@@ -46,15 +49,29 @@ public:
     };
     void ShowGlyphs(ShowGlyphType show);
 
+    // Job states, in the order they are stacked in site bars
+    enum StateType {
+        Matching,
+        Submitting,
+        Queued,
+        Running,
+        Done,
+        Failed,
+        NumStates
+    };
+
     Job(const std::string& jobID, double radius, vtkRenderer* renderer, Site* startSite, 
         double height, double jobVelocity, 
         ShowGlyphType showWhichGlyphs, bool showGhostJobs, bool fadeGhostJobs, bool showJobPath, bool showJobTrail, 
-        double labelHeight, bool labelFaceCamera);
+        LabelLayer* labelLayer, bool labelFaceCamera, JobMotion* jobMotion, LineBuffer* lineBuffer, BatchRenderer* batchRenderer = NULL);
     virtual ~Job();
 
     Site* GetSite();
 
     bool SetState(const std::string& state);
+    StateType GetState();
+    static bool IsValidState(const std::string& state);
+    static const double* GetStateColor(StateType state);
     void SetSite(Site* newSite);
     void SetScienceColor(double r, double g, double b);
 
@@ -74,8 +91,17 @@ public:
     const std::string& GetName();
     void SetName(const std::string& jobName);
 
+    // The workflow this job is in, if any, and its slot in the workflow's jobs.  Set by the
+    // workflow.
+    Workflow* GetWorkflow();
+    int GetWorkflowSlot();
+    void SetWorkflow(Workflow* jobWorkflow, int slot);
+
     bool IsDone();
 
+    // Whether travelling between sites
+    bool IsMoving();
+
 
     // Colors
     static double matchingColor[3];
@@ -86,10 +112,13 @@ public:
     static double failedColor[3];
 
     // For animating 
-    const Vec3& GetPosition();
+    Vec3 GetPosition();
     void SetPosition(const Vec3& pos);
     void SetOldPosition(const Vec3& pos);
-    void UpdatePosition();
+
+    // Push the results of a JobMotion step for this job's row to the glyphs and lines.
+    // Returns true if anything moved.
+    bool UpdateMotion(int numSteps);
     void SetVelocity(double v);
 
     void ShowGhost(bool show);
@@ -100,6 +129,10 @@ public:
     // Text caption
     void ShowName(bool show);
 
+    // Hide the glyphs when sites draw bars instead.  Only needed without a batch renderer,
+    // whose glyph sets are hidden as a whole.
+    void ShowDetail(bool show);
+
     // Scale color
     static void ScaleColor(double scale);
 
@@ -109,47 +142,71 @@ private:
 
     DataTransfer* data;
 
-    vtkCylinderSource* statusGlyph;
-    vtkActor* statusActor;
-    vtkCylinderSource* ghostStatusGlyph;
-    vtkActor* ghostStatusActor;
-    vtkCylinderSource* oldGhostStatusGlyph;
-    vtkActor* oldGhostStatusActor;
-
-    vtkCylinderSource* scienceGlyph;
-    vtkActor* scienceActor;
-    vtkCylinderSource* ghostScienceGlyph;
-    vtkActor* ghostScienceActor;
-    vtkCylinderSource* oldGhostScienceGlyph;
-    vtkActor* oldGhostScienceActor;
-
-    vtkLineSource* path;
-    vtkActor* pathActor;
-    vtkLineSource* trail;
-    vtkActor* trailActor;    
+    // Status and science glyphs, plus ghosts of each at the new and old sites.  If using a 
+    // batch renderer, each glyph is a row in one of its glyph sets.  Otherwise each glyph 
+    // has its own actor.
+    BatchRenderer* batch;
+    vtkCylinderSource* glyphs[BatchRenderer::NumJobGlyphs];
+    vtkActor* glyphActors[BatchRenderer::NumJobGlyphs];
+    int glyphRows[BatchRenderer::NumJobGlyphs];
+
+    double glyphRadius;
+    double glyphHeight;
+    double statusColor[3];
+    double scienceColor[3];
+
+    // The path and trail are rows in the shared line buffer while the job is moving, and -1
+    // otherwise
+    LineBuffer* lines;
+    int pathRow;
+    int trailRow;
     
-    // For displaying the name
-    vtkCaptionActor2D* text;
+    // For displaying the name.  Labels facing the camera are a row in the shared label layer
+    // while shown, and -1 otherwise.
+    LabelLayer* labels;
+    int labelRow;
     vtkTextActor3D* text3D;
 
     std::string name;
 
-    bool moving;
-    Vec3 position;
-    Vec3 oldPosition;
-    double velocity;
+    Workflow* workflow;
+    int workflowSlot;
+
+    // Position, velocity, opacity, and whether moving are a row in the shared job motion
+    // arrays
+    JobMotion* motion;
+    int motionRow;
 
     ShowGlyphType showGlyphs;
     bool showGhosts;
-    bool fadeGhosts;
     bool showPath;
     bool showTrail;
 
     bool showName;
 
     bool isDone;
+    StateType state;
 
     void UpdateGhostOpacities(double fraction);
+
+    // Work on either actors or glyph set rows
+    void ShowGlyph(int glyph, bool show);
+    void SetGlyphPosition(int glyph, const Vec3& pos);
+    void SetGlyphColor(int glyph, const double* color);
+    void SetGlyphOpacity(int glyph, double glyphOpacity);
+    void UpdateGlyphSizes();
+
+    // Name label
+    void UpdateLabelColor();
+    void UpdateLabelPosition();
+
+    // Path and trail rows
+    void CreateLines();
+    void RemoveLines();
+    void UpdateLineColors();
+
+    // Move the status and science glyphs
+    void SetCurrentPosition(const Vec3& pos);
 };
 
 
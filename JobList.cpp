@@ -14,21 +14,37 @@
 #include <wx/log.h>
 
 
-JobList::JobList(Site* matchingSiteIn, DoneSite* doneSiteIn, vtkRenderer* ren, bool useDarkBackground)
+JobList::JobList(Site* matchingSiteIn, DoneSite* doneSiteIn, vtkRenderer* ren, bool useDarkBackground, bool useInstancedGlyphs)
 : matchingSite(matchingSiteIn), doneSite(doneSiteIn), renderer(ren), darkBackground(useDarkBackground) {
     jobRadius = 10.0;
     jobHeight = jobRadius * 0.5;
     jobVelocity = 20.0;
 
+    timeStep = 0.01;
+    ResetClock();
+
+    retainDoneJobs = 0;
+    retainDoneSeconds = 0.0;
+    rememberRetiredJobs = 100000;
+    numRetired = 0;
+
     showGlyphs = Job::ShowStatusOnly;
     showGhosts = true;
     fadeGhosts = true;
     showPaths = true;
     showTrails = true;
+    showDetail = true;
 
-    labelHeight = 0.0;
     labelFaceCamera = true;
 
+    // Same glyph resolution as Object
+    if (useInstancedGlyphs) batch = new BatchRenderer(renderer, 16);
+    else batch = NULL;
+
+    motion = new JobMotion();
+    lines = new LineBuffer(renderer);
+    labels = new LabelLayer(renderer, LabelLayer::Left);
+
     scienceLegend = vtkLegendBoxActor::New();
     CreateScienceLegend();
     CreateScienceColors();
@@ -40,6 +56,11 @@ JobList::~JobList() {
         delete jobs[i];
     }
 
+    if (batch) delete batch;
+    delete lines;
+    delete labels;
+    delete motion;
+
     scienceLegend->Delete();
 }
 
@@ -52,15 +73,21 @@ void JobList::SetDefaultSites(Site* matchingSiteIn, DoneSite* doneSiteIn) {
 
 Job* JobList::Get(const std::string& jobId, WorkflowList* workflowList) {
     // Search for this Id
-    for (int i = 0; i < (int)jobs.size(); i++) {
-        if (jobs[i]->GetID() == jobId) {
-            return jobs[i];
-        }
+    std::unordered_map<std::string, int>::iterator it = jobIndex.find(jobId);
+    if (it != jobIndex.end()) {
+        return jobs[it->second];
     }
 
+    // A retired job that comes back, e.g. resubmitted after failing, is only counted once
+    std::unordered_map<std::string, RetiredJob>::iterator retired = retiredJobs.find(jobId);
+    if (retired != retiredJobs.end()) UnretireJob(retired);
+
     // It's not there, so add it
-    jobs.push_back(new Job(jobId, jobRadius, renderer, matchingSite, jobHeight, jobVelocity, showGlyphs, showGhosts, fadeGhosts, showPaths, showTrails, labelHeight, labelFaceCamera));
+    jobs.push_back(new Job(jobId, jobRadius, renderer, matchingSite, jobHeight, jobVelocity, showGlyphs, showGhosts, fadeGhosts, showPaths, showTrails, labels, labelFaceCamera, motion, lines, batch));
     jobs.back()->SetScienceColor(scienceColors[0].r, scienceColors[0].g, scienceColors[0].b);
+    jobIndex[jobId] = (int)jobs.size() - 1;
+
+    if (!showDetail) jobs.back()->ShowDetail(false);
 
     // Change default if a workflow is currently highlighted
     if (workflowList->IsCurrent()) {
@@ -68,16 +95,49 @@ Job* JobList::Get(const std::string& jobId, WorkflowList* workflowList) {
     }
 
     // Update the number of sites
-    if (doneSite) doneSite->SetNumJobs((int)jobs.size());
+    if (doneSite) doneSite->SetNumJobs((int)jobs.size() + numRetired);
 
     return jobs.back();
 }
 
 
-void JobList::UpdatePositions() {
-    for (int i = 0; i < (int)jobs.size(); i++) {
-        jobs[i]->UpdatePosition();
+bool JobList::UpdatePositions() {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - lastUpdateTime).count();
+    lastUpdateTime = now;
+
+    // Don't jump after a stall, such as a modal dialog
+    timeAccumulator += elapsed < 1.0 ? elapsed : 1.0;
+
+    // Slow frames take bigger steps rather than more of them
+    int numSteps = (int)(timeAccumulator / timeStep);
+    timeAccumulator -= numSteps * timeStep;
+
+    // Step all jobs at once, then update only the ones that moved
+    bool changed = false;
+    const std::vector<int>& moved = motion->Step(numSteps);
+    for (int i = 0; i < (int)moved.size(); i++) {
+        if (motion->GetJob(moved[i])->UpdateMotion(numSteps)) changed = true;
     }
+
+    if (batch) batch->Update();
+    lines->Update();
+
+    return changed;
+}
+
+bool JobList::UpdateLabels() {
+    return labels->Update();
+}
+
+
+void JobList::SetTimeStep(double seconds) {
+    timeStep = seconds > 0.0 ? seconds : 0.01;
+}
+
+void JobList::ResetClock() {
+    timeAccumulator = 0.0;
+    lastUpdateTime = std::chrono::steady_clock::now();
 }
 
 
@@ -177,8 +237,24 @@ void JobList::ShowTrails(bool show) {
 }
 
 
+void JobList::ShowDetail(bool show) {
+    showDetail = show;
+
+    if (batch) {
+        for (int i = 0; i < BatchRenderer::NumJobGlyphs; i++) {
+            batch->GetJobGlyphs(i)->GetActor()->SetVisibility(showDetail);
+        }
+    }
+    else {
+        for (int i = 0; i < (int)jobs.size(); i++) {
+            jobs[i]->ShowDetail(showDetail);
+        }
+    }
+}
+
+
 void JobList::SetLabelHeight(double height) {
-    labelHeight = height;
+    labels->SetLabelHeight(height);
 }
 
 void JobList::LabelFaceCamera(bool faceCamera) {
@@ -186,21 +262,107 @@ void JobList::LabelFaceCamera(bool faceCamera) {
 }
 
 
-void JobList::RemoveDuplicates(std::vector<std::string> jobIDs) {
-    for (int i = 0; i < (int)jobs.size(); i++) {
-        for (int j = 0; j < (int)jobIDs.size(); j++) {
-            if (jobs[i]->GetID() == jobIDs[j]) {
-                delete jobs[i];
-                jobs.erase(jobs.begin() + i);
-                i--;
-                break;
-            }
+void JobList::RemoveDuplicates(const std::vector<std::string>& jobIDs) {
+    for (int i = 0; i < (int)jobIDs.size(); i++) {
+        std::unordered_map<std::string, int>::iterator it = jobIndex.find(jobIDs[i]);
+        if (it != jobIndex.end()) {
+            RemoveJob(it->second);
+            continue;
         }
+
+        // A retired duplicate only leaves a count behind
+        std::unordered_map<std::string, RetiredJob>::iterator retired = retiredJobs.find(jobIDs[i]);
+        if (retired != retiredJobs.end()) UnretireJob(retired);
     }
+
+    if (doneSite) doneSite->SetNumJobs((int)jobs.size() + numRetired);
 }
 
 
-const double* JobList::GetScienceColor(std::string& science) {
+void JobList::SetRetainDoneJobs(int count) {
+    retainDoneJobs = count;
+}
+
+void JobList::SetRetainDoneSeconds(double seconds) {
+    retainDoneSeconds = seconds;
+}
+
+void JobList::SetRememberRetiredJobs(int count) {
+    rememberRetiredJobs = count;
+}
+
+
+void JobList::JobStateChanged(Job* job) {
+    // Nothing to time without limits
+    if (retainDoneJobs <= 0 && retainDoneSeconds <= 0.0) return;
+
+    Job::StateType state = job->GetState();
+    if (state != Job::Done && state != Job::Failed) {
+        finishTimes.erase(job->GetID());
+        return;
+    }
+
+    // Already finished, e.g. failed and then done
+    if (finishTimes.find(job->GetID()) != finishTimes.end()) return;
+
+    FinishedJob finished;
+    finished.id = job->GetID();
+    finished.time = std::chrono::steady_clock::now();
+
+    finishTimes[finished.id] = finished.time;
+    finishedJobs.push_back(finished);
+}
+
+
+bool JobList::RetireJobs(WorkflowList* workflowList) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    bool retired = false;
+
+    // Jobs still moving to their sites
+    std::vector<FinishedJob> moving;
+
+    // Oldest first, so stop at the first job within the limits
+    while (!finishedJobs.empty()) {
+        const FinishedJob& finished = finishedJobs.front();
+
+        std::unordered_map<std::string, std::chrono::steady_clock::time_point>::iterator it = finishTimes.find(finished.id);
+        if (it == finishTimes.end() || it->second != finished.time) {
+            finishedJobs.pop_front();
+            continue;
+        }
+
+        bool overCount = retainDoneJobs > 0 && (int)finishTimes.size() > retainDoneJobs;
+        bool overAge = retainDoneSeconds > 0.0 && 
+                       std::chrono::duration<double>(now - finished.time).count() > retainDoneSeconds;
+        if (!overCount && !overAge) break;
+
+        std::unordered_map<std::string, int>::iterator index = jobIndex.find(finished.id);
+        if (index == jobIndex.end()) {
+            finishedJobs.pop_front();
+            continue;
+        }
+
+        // Wait until it reaches its site, but keep going with the jobs behind it
+        if (jobs[index->second]->IsMoving()) {
+            moving.push_back(finished);
+            finishedJobs.pop_front();
+            continue;
+        }
+
+        finishedJobs.pop_front();
+
+        RetireJob(index->second, workflowList);
+        retired = true;
+    }
+
+    // Try the moving jobs again next time, still oldest first
+    finishedJobs.insert(finishedJobs.begin(), moving.begin(), moving.end());
+
+    return retired;
+}
+
+
+const double* JobList::GetScienceColor(const std::string& science) {
     for (int i = 0; i < (int)sciences.size(); i++) {
         if (science == sciences[i]) {
             scienceColor[0] = scienceColors[i].r;
@@ -257,15 +419,84 @@ vtkLegendBoxActor* JobList::GetScienceLegend() {
 }
 
 
-void JobList::Reset() {
+void JobList::Reset(bool keepScienceColors) {
     for (int i = 0; i < (int)jobs.size(); i++) {
         delete jobs[i];
     }
     jobs.clear();
+    jobIndex.clear();
+
+    finishedJobs.clear();
+    finishTimes.clear();
+    retiredJobs.clear();
+    retiredOrder.clear();
+    numRetired = 0;
+
+    if (!keepScienceColors) {
+        sciences.clear();
+        scienceColors.clear();
+        CreateScienceLegend();
+    }
+}
 
-    sciences.clear();
-    scienceColors.clear();
-    CreateScienceLegend();
+
+void JobList::RemoveJob(int index) {
+    Job* job = jobs[index];
+
+    jobIndex.erase(job->GetID());
+    finishTimes.erase(job->GetID());
+
+    // Move the last job into this slot
+    if (index != (int)jobs.size() - 1) {
+        jobs[index] = jobs.back();
+        jobIndex[jobs[index]->GetID()] = index;
+    }
+    jobs.pop_back();
+
+    delete job;
+}
+
+
+void JobList::RetireJob(int index, WorkflowList* workflowList) {
+    Job* job = jobs[index];
+    Site* site = job->GetSite();
+    Workflow* workflow = job->GetWorkflow();
+
+    if (site) site->RetireJob(job);
+
+    // Keep what is needed to count it again if it comes back, or to remove it as a duplicate
+    RetiredJob retired;
+    retired.site = site;
+    retired.state = job->GetState();
+    retired.workflow = workflowList->RetireJob(job) ? workflow : NULL;
+    retired.name = job->GetName();
+    retired.order = retiredOrder.insert(retiredOrder.end(), job->GetID());
+    retiredJobs[job->GetID()] = retired;
+
+    // Forget the oldest
+    while (rememberRetiredJobs > 0 && (int)retiredOrder.size() > rememberRetiredJobs) {
+        std::unordered_map<std::string, RetiredJob>::iterator it = retiredJobs.find(retiredOrder.front());
+        if (it->second.workflow) it->second.workflow->ForgetRetiredJob(it->second.name, it->first);
+
+        retiredJobs.erase(it);
+        retiredOrder.pop_front();
+    }
+
+    numRetired++;
+
+    RemoveJob(index);
+}
+
+
+void JobList::UnretireJob(std::unordered_map<std::string, RetiredJob>::iterator retired) {
+    RetiredJob& job = retired->second;
+
+    if (job.site) job.site->UnretireJob(job.state);
+    if (job.workflow) job.workflow->ForgetRetiredJob(job.name, retired->first);
+
+    retiredOrder.erase(job.order);
+    retiredJobs.erase(retired);
+    numRetired--;
 }
 
 
@@ -13,11 +13,20 @@
 #define JOBLIST_H
 
 
+#include <chrono>
+#include <deque>
+#include <list>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <vtkRenderer.h>
 #include <vtkLegendBoxActor.h>
 
+#include "BatchRenderer.h"
+#include "JobMotion.h"
+#include "LabelLayer.h"
+#include "LineBuffer.h"
 #include "Job.h"
 #include "Site.h"
 #include "WorkflowList.h"
@@ -25,7 +34,7 @@
 
 class JobList {
 public:
-    JobList(Site* matchingSiteIn, DoneSite* doneSiteIn, vtkRenderer* ren, bool useDarkBackground);
+    JobList(Site* matchingSiteIn, DoneSite* doneSiteIn, vtkRenderer* ren, bool useDarkBackground, bool useInstancedGlyphs = false);
     ~JobList();
 
     // Set the default sites
@@ -34,8 +43,18 @@ public:
     // Get a job, creating it if necessary
     Job* Get(const std::string& jobId, WorkflowList* workflowList);
 
-    // Animate the jobs
-    void UpdatePositions();
+    // Animate the jobs by the wall-clock time since the last call, in whole fixed time steps.
+    // Returns true if anything moved.
+    bool UpdatePositions();
+
+    // Seconds per animation step.  Jobs move by their velocity each step.
+    void SetTimeStep(double seconds);
+
+    // Start timing from now, e.g. after a pause
+    void ResetClock();
+
+    // Place the job labels for the current view.  Returns true if they changed.
+    bool UpdateLabels();
 
     // Get/set job parameters
     double GetJobRadius();
@@ -59,25 +78,45 @@ public:
     void ShowPaths(bool show);
     void ShowTrails(bool show);
 
+    // Hide the job glyphs when sites draw bars instead.  Paths and trails are still shown.
+    void ShowDetail(bool show);
+
     // Text label height
     void SetLabelHeight(double height);
     void LabelFaceCamera(bool jobLabelFaceCamera);
 
-    void RemoveDuplicates(std::vector<std::string> jobIDs);
+    void RemoveDuplicates(const std::vector<std::string>& jobIDs);
+
+    // Done and failed jobs past these limits are deleted and only counted at their sites.
+    // 0 : No limit
+    void SetRetainDoneJobs(int count);
+    void SetRetainDoneSeconds(double seconds);
+
+    // Retired jobs remembered so they can be counted again if they come back.  0 : No limit
+    void SetRememberRetiredJobs(int count);
+
+    // Call after setting a job's state, to start or stop timing how long it has been finished
+    void JobStateChanged(Job* job);
+
+    // Retire finished jobs past the limits that aren't moving.  Returns true if any were retired.
+    bool RetireJobs(WorkflowList* workflowList);
 
     // Get the color for this science
-    const double* GetScienceColor(std::string& science);
+    const double* GetScienceColor(const std::string& science);
 
     // Get the science legend
     vtkLegendBoxActor* GetScienceLegend();
 
-    // Reset the data
-    void Reset();
+    // Reset the data, optionally keeping the colors assigned to sciences
+    void Reset(bool keepScienceColors = false);
 
 private:
     // List of jobs
     std::vector<Job*> jobs;
 
+    // Index of each job in the list, by job ID
+    std::unordered_map<std::string, int> jobIndex;
+
     // Start site and done site
     Site* matchingSite;
     DoneSite* doneSite;
@@ -87,14 +126,51 @@ private:
     double jobHeight;
     double jobVelocity;
 
+    // Fixed time step animation.  Time left over from one update carries to the next.
+    double timeStep;
+    double timeAccumulator;
+    std::chrono::steady_clock::time_point lastUpdateTime;
+
+    // Retention of finished jobs
+    int retainDoneJobs;
+    double retainDoneSeconds;
+
+    // Finished jobs, in the order they finished.  A job that finishes again gets a new entry,
+    // and the old one is skipped because its time no longer matches.
+    struct FinishedJob {
+        std::string id;
+        std::chrono::steady_clock::time_point time;
+    };
+    std::deque<FinishedJob> finishedJobs;
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> finishTimes;
+
+    // Retired jobs that can still come back or be removed as duplicates, by job ID, and the
+    // total retired.  Only the most recent are remembered, in the order they retired.  Older
+    // ones are just counted again.
+    struct RetiredJob {
+        Site* site;
+        Job::StateType state;
+
+        // Set if its workflow keeps it for finding duplicates
+        Workflow* workflow;
+        std::string name;
+
+        // Its place in the order
+        std::list<std::string>::iterator order;
+    };
+    std::unordered_map<std::string, RetiredJob> retiredJobs;
+    std::list<std::string> retiredOrder;
+    int rememberRetiredJobs;
+    int numRetired;
+
     // Visualization effects
     Job::ShowGlyphType showGlyphs;
     bool showGhosts;
     bool fadeGhosts;
     bool showPaths;
     bool showTrails;
+    bool showDetail;
 
-    double labelHeight;
     bool labelFaceCamera;
 
     bool darkBackground;
@@ -111,8 +187,29 @@ private:
 
     vtkRenderer* renderer;
 
+    // Draws all job glyphs with instanced mappers, or NULL to use an actor per glyph
+    BatchRenderer* batch;
+
+    // Animation state of all jobs
+    JobMotion* motion;
+
+    // Draws the paths and trails of all moving jobs
+    LineBuffer* lines;
+
+    // Draws the names of all jobs
+    LabelLayer* labels;
+
     vtkLegendBoxActor* scienceLegend;
 
+    // Remove a job by swapping the last job into its place
+    void RemoveJob(int index);
+
+    // Count a job at its site and remove it
+    void RetireJob(int index, WorkflowList* workflowList);
+
+    // Take a retired job's count back from its site and forget it
+    void UnretireJob(std::unordered_map<std::string, RetiredJob>::iterator retired);
+
     void CreateScienceLegend();
     void UpdateScienceLegend();
 
@@ -0,0 +1,271 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        JobMotion.cpp
+//
+// Author:      David Borland
+//
+// Description: Implementation of JobMotion class for MatchMaker.  Keeps the animation state
+//              of all jobs in contiguous arrays, one row per job, and steps every moving job
+//              in one pass over them.  Jobs hold a row number and are only told about the
+//              results when they moved.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "JobMotion.h"
+
+#include <math.h>
+
+
+JobMotion::JobMotion() {
+    numMoving = 0;
+    numTransferring = 0;
+}
+
+JobMotion::~JobMotion() {
+}
+
+
+int JobMotion::AddRow(Job* job) {
+    int row;
+
+    if (freeRows.size() > 0) {
+        row = freeRows.back();
+        freeRows.pop_back();
+    }
+    else {
+        row = (int)jobs.size();
+
+        jobs.push_back(NULL);
+
+        currentX.push_back(0.0);
+        currentY.push_back(0.0);
+        currentZ.push_back(0.0);
+        targetX.push_back(0.0);
+        targetY.push_back(0.0);
+        targetZ.push_back(0.0);
+        startX.push_back(0.0);
+        startY.push_back(0.0);
+        startZ.push_back(0.0);
+
+        velocity.push_back(0.0);
+        opacity.push_back(1.0);
+        fade.push_back(0.0);
+        moving.push_back(0.0);
+        arrived.push_back(0.0);
+
+        transferring.push_back(0);
+        ghostOpacity.push_back(0.0);
+        oldGhostOpacity.push_back(0.0);
+    }
+
+    jobs[row] = job;
+
+    SetCurrent(row, Vec3(0.0, 0.0, 0.0));
+    SetTarget(row, Vec3(0.0, 0.0, 0.0));
+    SetStart(row, Vec3(0.0, 0.0, 0.0));
+    velocity[row] = 0.0;
+    opacity[row] = 1.0;
+    fade[row] = 0.0;
+    moving[row] = 0.0;
+    arrived[row] = 0.0;
+    transferring[row] = 0;
+
+    return row;
+}
+
+void JobMotion::RemoveRow(int row) {
+    // Free rows are never moving, so the step leaves them alone
+    jobs[row] = NULL;
+    SetMoving(row, false);
+    SetTransferring(row, false);
+
+    freeRows.push_back(row);
+}
+
+
+Job* JobMotion::GetJob(int row) {
+    return jobs[row];
+}
+
+
+Vec3 JobMotion::GetCurrent(int row) {
+    return Vec3(currentX[row], currentY[row], currentZ[row]);
+}
+
+Vec3 JobMotion::GetTarget(int row) {
+    return Vec3(targetX[row], targetY[row], targetZ[row]);
+}
+
+Vec3 JobMotion::GetStart(int row) {
+    return Vec3(startX[row], startY[row], startZ[row]);
+}
+
+void JobMotion::SetCurrent(int row, const Vec3& pos) {
+    currentX[row] = pos.X();
+    currentY[row] = pos.Y();
+    currentZ[row] = pos.Z();
+}
+
+void JobMotion::SetTarget(int row, const Vec3& pos) {
+    targetX[row] = pos.X();
+    targetY[row] = pos.Y();
+    targetZ[row] = pos.Z();
+}
+
+void JobMotion::SetStart(int row, const Vec3& pos) {
+    startX[row] = pos.X();
+    startY[row] = pos.Y();
+    startZ[row] = pos.Z();
+}
+
+
+bool JobMotion::GetMoving(int row) {
+    return moving[row] != 0.0;
+}
+
+void JobMotion::SetMoving(int row, bool isMoving) {
+    if (isMoving == (moving[row] != 0.0)) return;
+
+    moving[row] = isMoving ? 1.0 : 0.0;
+    numMoving += isMoving ? 1 : -1;
+}
+
+
+void JobMotion::SetVelocity(int row, double v) {
+    velocity[row] = v;
+}
+
+
+double JobMotion::GetOpacity(int row) {
+    return opacity[row];
+}
+
+void JobMotion::SetOpacity(int row, double jobOpacity) {
+    opacity[row] = jobOpacity;
+}
+
+void JobMotion::SetFade(int row, bool fadeGhosts) {
+    fade[row] = fadeGhosts ? 1.0 : 0.0;
+}
+
+
+void JobMotion::SetTransferring(int row, bool isTransferring) {
+    if (isTransferring == (transferring[row] != 0)) return;
+
+    transferring[row] = isTransferring ? 1 : 0;
+    numTransferring += isTransferring ? 1 : -1;
+}
+
+
+const std::vector<int>& JobMotion::Step(int numSteps) {
+    changedRows.clear();
+
+    if (numSteps <= 0 || jobs.empty()) return changedRows;
+
+    // Nothing to animate
+    if (numMoving == 0 && numTransferring == 0) return changedRows;
+
+    int numRows = (int)jobs.size();
+
+    // Only data transfers, so just collect their rows
+    if (numMoving == 0) {
+        for (int i = 0; i < numRows; i++) {
+            if (transferring[i]) {
+                arrived[i] = 0.0;
+                changedRows.push_back(i);
+            }
+        }
+
+        return changedRows;
+    }
+
+    double steps = numSteps;
+
+    // Raw pointers, so the loop doesn't go through the vectors
+    double* cx = &currentX[0];
+    double* cy = &currentY[0];
+    double* cz = &currentZ[0];
+    const double* tx = &targetX[0];
+    const double* ty = &targetY[0];
+    const double* tz = &targetZ[0];
+    const double* sx = &startX[0];
+    const double* sy = &startY[0];
+    const double* sz = &startZ[0];
+    const double* v = &velocity[0];
+    const double* o = &opacity[0];
+    const double* f = &fade[0];
+    const double* m = &moving[0];
+    double* a = &arrived[0];
+    double* g = &ghostOpacity[0];
+    double* og = &oldGhostOpacity[0];
+
+    // One pass over every row, without branches so the compiler can vectorize it.  Rows that
+    // aren't moving get a zero step, so stay where they are.  The arrays never overlap.
+#if defined(_MSC_VER)
+#pragma loop(ivdep)
+#elif defined(__clang__)
+#pragma clang loop vectorize(assume_safety)
+#elif defined(__GNUC__)
+#pragma GCC ivdep
+#endif
+    for (int i = 0; i < numRows; i++) {
+        double dx = tx[i] - cx[i];
+        double dy = ty[i] - cy[i];
+        double dz = tz[i] - cz[i];
+        double dist = sqrt(dx * dx + dy * dy + dz * dz);
+
+        double step = v[i] * steps * m[i];
+
+        // Fraction of the remaining distance to move, which is 1 on arrival.  Adding the
+        // arrival flag keeps the divisor from being 0.
+        double done = step >= dist;
+        double t = done + (1.0 - done) * step / (dist + done);
+
+        cx[i] += dx * t;
+        cy[i] += dy * t;
+        cz[i] += dz * t;
+
+        a[i] = m[i] * done;
+
+        // Ghosts fade from the old site to the new one, by the fraction of the total
+        // distance left before this step
+        double ex = sx[i] - tx[i];
+        double ey = sy[i] - ty[i];
+        double ez = sz[i] - tz[i];
+        double total = sqrt(ex * ex + ey * ey + ez * ez);
+        double frac = dist / (total + (total == 0.0));
+
+        double maxOpacity = o[i];
+        double minOpacity = maxOpacity * 0.25;
+        double faded = (maxOpacity - frac) * (maxOpacity - minOpacity) + minOpacity;
+        double oldFaded = frac * (maxOpacity - minOpacity) + minOpacity;
+        double fixed = maxOpacity * 0.5;
+
+        g[i] = f[i] * faded + (1.0 - f[i]) * fixed;
+        og[i] = f[i] * oldFaded + (1.0 - f[i]) * fixed;
+    }
+
+    // Collect the rows that changed, and stop the ones that arrived
+    for (int i = 0; i < numRows; i++) {
+        if (moving[i] != 0.0 || transferring[i]) changedRows.push_back(i);
+
+        moving[i] -= arrived[i];
+        numMoving -= (int)arrived[i];
+    }
+
+    return changedRows;
+}
+
+
+bool JobMotion::GetArrived(int row) {
+    return arrived[row] != 0.0;
+}
+
+double JobMotion::GetGhostOpacity(int row) {
+    return ghostOpacity[row];
+}
+
+double JobMotion::GetOldGhostOpacity(int row) {
+    return oldGhostOpacity[row];
+}
\ No newline at end of file
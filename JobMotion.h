@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        JobMotion.h
+//
+// Author:      David Borland
+//
+// Description: Interface of JobMotion class for MatchMaker.  Keeps the animation state of
+//              all jobs in contiguous arrays, one row per job, and steps every moving job in
+//              one pass over them.  Jobs hold a row number and are only told about the
+//              results when they moved.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef JOBMOTION_H
+#define JOBMOTION_H
+
+
+#include <vector>
+
+#include <Vec3.h>
+
+
+class Job;
+
+
+class JobMotion {
+public:
+    JobMotion();
+    ~JobMotion();
+
+    // Get a row for a new job, which starts at the origin and not moving, and give it back
+    // when done
+    int AddRow(Job* job);
+    void RemoveRow(int row);
+
+    Job* GetJob(int row);
+
+    // Current position, the position being moved to, and the position being moved from
+    Vec3 GetCurrent(int row);
+    Vec3 GetTarget(int row);
+    Vec3 GetStart(int row);
+    void SetCurrent(int row, const Vec3& pos);
+    void SetTarget(int row, const Vec3& pos);
+    void SetStart(int row, const Vec3& pos);
+
+    bool GetMoving(int row);
+    void SetMoving(int row, bool moving);
+
+    // Distance moved per step
+    void SetVelocity(int row, double velocity);
+
+    // Job opacity, and whether ghosts fade as the job moves
+    double GetOpacity(int row);
+    void SetOpacity(int row, double opacity);
+    void SetFade(int row, bool fade);
+
+    // Rows with a data transfer are animated even when not moving
+    void SetTransferring(int row, bool transferring);
+
+    // Move every moving row by a number of steps.  Returns the rows that moved or have a data
+    // transfer.
+    const std::vector<int>& Step(int numSteps);
+
+    // Results of the last step for a row
+    bool GetArrived(int row);
+    double GetGhostOpacity(int row);
+    double GetOldGhostOpacity(int row);
+
+private:
+    std::vector<Job*> jobs;
+
+    std::vector<double> currentX;
+    std::vector<double> currentY;
+    std::vector<double> currentZ;
+    std::vector<double> targetX;
+    std::vector<double> targetY;
+    std::vector<double> targetZ;
+    std::vector<double> startX;
+    std::vector<double> startY;
+    std::vector<double> startZ;
+
+    std::vector<double> velocity;
+    std::vector<double> opacity;
+
+    // Flags the step reads or writes are 0.0 or 1.0, so it can use them as numbers without
+    // mixing element sizes
+    std::vector<double> fade;
+    std::vector<double> moving;
+    std::vector<double> arrived;
+
+    std::vector<unsigned char> transferring;
+
+    std::vector<double> ghostOpacity;
+    std::vector<double> oldGhostOpacity;
+
+    std::vector<int> changedRows;
+
+    // Rows moving or with a data transfer, so the step can skip the pass when there are none
+    int numMoving;
+    int numTransferring;
+
+    // Rows that can be reused
+    std::vector<int> freeRows;
+};
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,230 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        LabelLayer.cpp
+//
+// Author:      David Borland
+//
+// Description: Implementation of LabelLayer class for MatchMaker.  Draws many screen-aligned
+//              labels with a label placement mapper instead of a caption actor per label.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "LabelLayer.h"
+
+#include <vtkPointData.h>
+
+
+LabelLayer::LabelLayer(vtkRenderer* ren, Justification labelJustification) 
+: renderer(ren), justification(labelJustification) {
+    labelHeight = 0.0;
+    fontSize = 12;
+
+    points = vtkPoints::New();
+
+    labels = vtkStringArray::New();
+    labels->SetName("Labels");
+
+    polyData = vtkPolyData::New();
+    polyData->SetPoints(points);
+    polyData->GetPointData()->AddArray(labels);
+
+    // Each label's color is set by the render strategy
+    textProperty = vtkTextProperty::New();
+    textProperty->SetFontSize(fontSize);
+    textProperty->SetColor(1.0, 1.0, 1.0);
+    textProperty->SetVerticalJustificationToTop();
+    if (justification == Centered) textProperty->SetJustificationToCentered();
+    else textProperty->SetJustificationToLeft();
+    textProperty->BoldOff();
+    textProperty->ShadowOff();
+    textProperty->ItalicOff();
+
+    hierarchy = vtkPointSetToLabelHierarchy::New();
+    hierarchy->SetInput(polyData);
+    hierarchy->SetLabelArrayName("Labels");
+    hierarchy->SetTextProperty(textProperty);
+
+    // The FreeType strategy keeps the rasterized glyphs between frames
+    strategy = vtkMyLabelRenderStrategy::New();
+    strategy->SetDefaultTextProperty(textProperty);
+
+    // Labels that are off-screen or overlap others aren't placed
+    mapper = vtkLabelPlacementMapper::New();
+    mapper->SetInputConnection(hierarchy->GetOutputPort());
+    mapper->SetRenderStrategy(strategy);
+    mapper->PlaceAllLabelsOff();
+    mapper->UseDepthBufferOff();
+    mapper->SetShapeToNone();
+    mapper->SetMaximumLabelFraction(0.5);
+
+    actor = vtkActor2D::New();
+    actor->SetMapper(mapper);
+    actor->VisibilityOff();
+
+    renderer->AddViewProp(actor);
+
+    modified = false;
+    pointsModified = false;
+    labelsModified = false;
+    colorsModified = false;
+}
+
+
+LabelLayer::~LabelLayer() {
+    renderer->RemoveViewProp(actor);
+
+    points->Delete();
+    labels->Delete();
+    polyData->Delete();
+    textProperty->Delete();
+    hierarchy->Delete();
+    strategy->Delete();
+    mapper->Delete();
+    actor->Delete();
+}
+
+
+int LabelLayer::AddRow() {
+    int row;
+
+    if (freeRows.size() > 0) {
+        row = freeRows.back();
+        freeRows.pop_back();
+    }
+    else {
+        row = (int)rows.size();
+        rows.push_back(Row());
+    }
+
+    // Start with defaults
+    rows[row].text.clear();
+    rows[row].position[0] = rows[row].position[1] = rows[row].position[2] = 0.0;
+    rows[row].color = 0xFFFFFF;
+    rows[row].visible = false;
+    rows[row].point = -1;
+
+    strategy->SetLabelColor(row, rows[row].color);
+
+    return row;
+}
+
+void LabelLayer::RemoveRow(int row) {
+    // Hide it until it is reused
+    SetVisible(row, false);
+
+    freeRows.push_back(row);
+}
+
+
+void LabelLayer::SetText(int row, const std::string& text) {
+    if (text == rows[row].text) return;
+
+    rows[row].text = text;
+
+    if (rows[row].visible && rows[row].point >= 0) {
+        labels->SetValue(rows[row].point, vtkMyLabelRenderStrategy::GetKeyedLabel(text, row));
+
+        labelsModified = true;
+    }
+}
+
+void LabelLayer::SetPosition(int row, double x, double y, double z) {
+    rows[row].position[0] = x;
+    rows[row].position[1] = y;
+    rows[row].position[2] = z;
+
+    if (rows[row].visible && rows[row].point >= 0) {
+        points->SetPoint(rows[row].point, x, y, z);
+
+        pointsModified = true;
+    }
+}
+
+void LabelLayer::SetColor(int row, double r, double g, double b) {
+    // Quantize to bytes
+    unsigned int color = ((unsigned int)(r * 255.0 + 0.5) << 16) |
+                         ((unsigned int)(g * 255.0 + 0.5) << 8) |
+                          (unsigned int)(b * 255.0 + 0.5);
+
+    if (color == rows[row].color) return;
+
+    rows[row].color = color;
+
+    // Colors are looked up by row, so the labels don't change
+    strategy->SetLabelColor(row, color);
+
+    if (rows[row].visible) colorsModified = true;
+}
+
+void LabelLayer::SetVisible(int row, bool visible) {
+    if (rows[row].visible == visible) return;
+
+    rows[row].visible = visible;
+
+    modified = true;
+}
+
+
+void LabelLayer::SetLabelHeight(double height) {
+    labelHeight = height;
+}
+
+
+bool LabelLayer::Update() {
+    bool changed = false;
+
+    // Match the caption actor's height in pixels
+    int size = (int)(labelHeight * renderer->GetSize()[1] + 0.5);
+    size = size < 1 ? 1 : size;
+
+    if (size != fontSize) {
+        fontSize = size;
+        textProperty->SetFontSize(fontSize);
+
+        changed = true;
+    }
+
+    if (modified) {
+        // Refill from the visible rows
+        points->Reset();
+        labels->Reset();
+
+        for (int i = 0; i < (int)rows.size(); i++) {
+            Row& row = rows[i];
+
+            if (!row.visible) {
+                row.point = -1;
+                continue;
+            }
+
+            row.point = (int)points->InsertNextPoint(row.position);
+            labels->InsertNextValue(vtkMyLabelRenderStrategy::GetKeyedLabel(row.text, i));
+        }
+
+        actor->SetVisibility(points->GetNumberOfPoints() > 0);
+
+        modified = false;
+        pointsModified = true;
+        labelsModified = true;
+    }
+
+    // The strategy already has the colors, so just draw again
+    if (colorsModified) {
+        colorsModified = false;
+        changed = true;
+    }
+
+    // Only rebuild the hierarchy when the points or labels changed
+    if (pointsModified || labelsModified) {
+        if (pointsModified) points->Modified();
+        if (labelsModified) labels->Modified();
+        polyData->Modified();
+
+        pointsModified = false;
+        labelsModified = false;
+        changed = true;
+    }
+
+    return changed;
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        LabelLayer.h
+//
+// Author:      David Borland
+//
+// Description: Interface of LabelLayer class for MatchMaker.  Draws many screen-aligned labels
+//              with a label placement mapper instead of a caption actor per label.  Labels
+//              that are off-screen or would overlap others are culled each frame, across
+//              all colors, and the rasterized text is cached by the FreeType render
+//              strategy.  Each label is a row, so objects hold a row number instead of their
+//              own actors.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LABELLAYER_H
+#define LABELLAYER_H
+
+
+#include <vtkActor2D.h>
+#include <vtkLabelPlacementMapper.h>
+#include <vtkPointSetToLabelHierarchy.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkRenderer.h>
+#include <vtkStringArray.h>
+#include <vtkTextProperty.h>
+
+#include <string>
+#include <vector>
+
+#include "vtkMyLabelRenderStrategy.h"
+
+
+class LabelLayer {
+public:
+    enum Justification {
+        Left,
+        Centered
+    };
+
+    LabelLayer(vtkRenderer* ren, Justification labelJustification);
+    ~LabelLayer();
+
+    // Get a row for a new label, which starts hidden, and give it back when done
+    int AddRow();
+    void RemoveRow(int row);
+
+    // Set properties for a row
+    void SetText(int row, const std::string& text);
+    void SetPosition(int row, double x, double y, double z);
+    void SetColor(int row, double r, double g, double b);
+    void SetVisible(int row, bool visible);
+
+    // Height of the labels as a fraction of the viewport height, as for caption actors
+    void SetLabelHeight(double height);
+
+    // Push any changes to the mapper, and match the font size to the viewport.  Call once
+    // per frame.  Returns true if anything changed.
+    bool Update();
+
+private:
+    // One point and label for each visible row.  Every label goes through one hierarchy and
+    // mapper, so labels of different colors are culled against each other.  Each label is
+    // keyed by its row, which picks its color in the render strategy.
+    vtkPoints* points;
+    vtkStringArray* labels;
+    vtkPolyData* polyData;
+    vtkTextProperty* textProperty;
+    vtkPointSetToLabelHierarchy* hierarchy;
+    vtkMyLabelRenderStrategy* strategy;
+    vtkLabelPlacementMapper* mapper;
+    vtkActor2D* actor;
+
+    struct Row {
+        std::string text;
+        double position[3];
+
+        // Packed RGB
+        unsigned int color;
+
+        bool visible;
+
+        // Index of the row's point, if visible
+        int point;
+    };
+
+    std::vector<Row> rows;
+
+    // Rows that can be reused
+    std::vector<int> freeRows;
+
+    vtkRenderer* renderer;
+
+    Justification justification;
+    double labelHeight;
+    int fontSize;
+
+    // Visibility changes refill the points and labels.  Other changes are patched in place.
+    bool modified;
+    bool pointsModified;
+    bool labelsModified;
+    bool colorsModified;
+};
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,172 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        LineBuffer.cpp
+//
+// Author:      David Borland
+//
+// Description: Implementation of LineBuffer class for MatchMaker.  Draws many line segments
+//              with one polydata and one actor.  Each segment is a row with two points and an
+//              RGBA color, so objects hold a row number instead of their own line actors.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "LineBuffer.h"
+
+#include <vtkCellData.h>
+#include <vtkProperty.h>
+
+
+LineBuffer::LineBuffer(vtkRenderer* ren) : renderer(ren) {
+    points = vtkPoints::New();
+    lines = vtkCellArray::New();
+
+    colors = vtkUnsignedCharArray::New();
+    colors->SetName("Colors");
+    colors->SetNumberOfComponents(4);
+
+    polyData = vtkPolyData::New();
+    polyData->SetPoints(points);
+    polyData->SetLines(lines);
+    polyData->GetCellData()->SetScalars(colors);
+
+    // One mapper draws every line
+    mapper = vtkPolyDataMapper::New();
+    mapper->SetInput(polyData);
+    mapper->SetColorModeToDefault();
+    mapper->SetScalarModeToUseCellData();
+
+    actor = vtkActor::New();
+    actor->SetMapper(mapper);
+    actor->GetProperty()->SetAmbient(0.0);
+    actor->GetProperty()->SetDiffuse(1.0);
+    actor->GetProperty()->SetSpecular(0.0);
+    actor->GetProperty()->SetLineWidth(2);
+
+    renderer->AddViewProp(actor);
+
+    modified = false;
+    pointsModified = false;
+}
+
+
+LineBuffer::~LineBuffer() {
+    renderer->RemoveViewProp(actor);
+
+    points->Delete();
+    lines->Delete();
+    colors->Delete();
+    polyData->Delete();
+    mapper->Delete();
+    actor->Delete();
+}
+
+
+int LineBuffer::AddRow() {
+    int row;
+
+    if (freeRows.size() > 0) {
+        row = freeRows.back();
+        freeRows.pop_back();
+    }
+    else {
+        row = (int)rowVisible.size();
+
+        points->InsertNextPoint(0.0, 0.0, 0.0);
+        points->InsertNextPoint(0.0, 0.0, 0.0);
+
+        rowColors.resize(rowColors.size() + 4);
+        rowVisible.push_back(false);
+    }
+
+    // Start with defaults
+    rowColors[row * 4] = rowColors[row * 4 + 1] = rowColors[row * 4 + 2] = rowColors[row * 4 + 3] = 255;
+    SetVisible(row, false);
+
+    return row;
+}
+
+void LineBuffer::RemoveRow(int row) {
+    // Hide it until it is reused
+    SetVisible(row, false);
+
+    freeRows.push_back(row);
+}
+
+
+void LineBuffer::SetLine(int row, const Vec3& p1, const Vec3& p2) {
+    points->SetPoint(row * 2, p1.X(), p1.Y(), p1.Z());
+    points->SetPoint(row * 2 + 1, p2.X(), p2.Y(), p2.Z());
+
+    // Moving a line doesn't change the cells or colors
+    if (rowVisible[row]) pointsModified = true;
+}
+
+void LineBuffer::SetColor(int row, double r, double g, double b) {
+    unsigned char rgb[3] = { (unsigned char)(r * 255.0 + 0.5),
+                             (unsigned char)(g * 255.0 + 0.5),
+                             (unsigned char)(b * 255.0 + 0.5) };
+
+    unsigned char* c = &rowColors[row * 4];
+    if (c[0] == rgb[0] && c[1] == rgb[1] && c[2] == rgb[2]) return;
+
+    c[0] = rgb[0];
+    c[1] = rgb[1];
+    c[2] = rgb[2];
+
+    if (rowVisible[row]) modified = true;
+}
+
+void LineBuffer::SetOpacity(int row, double opacity) {
+    unsigned char a = (unsigned char)(opacity * 255.0 + 0.5);
+    if (rowColors[row * 4 + 3] == a) return;
+
+    rowColors[row * 4 + 3] = a;
+
+    if (rowVisible[row]) modified = true;
+}
+
+void LineBuffer::SetVisible(int row, bool visible) {
+    if (rowVisible[row] == visible) return;
+
+    rowVisible[row] = visible;
+
+    modified = true;
+}
+
+
+void LineBuffer::Update() {
+    if (!modified) {
+        // Only the points changed, which are patched in place
+        if (pointsModified) points->Modified();
+
+        pointsModified = false;
+        return;
+    }
+
+    // Only visible rows get cells, so hidden lines cost nothing to draw
+    lines->Reset();
+    colors->Reset();
+
+    for (int i = 0; i < (int)rowVisible.size(); i++) {
+        if (!rowVisible[i]) continue;
+
+        vtkIdType ids[2] = { i * 2, i * 2 + 1 };
+        lines->InsertNextCell(2, ids);
+
+        colors->InsertNextTupleValue(&rowColors[i * 4]);
+    }
+
+    points->Modified();
+    lines->Modified();
+    colors->Modified();
+    polyData->Modified();
+
+    modified = false;
+    pointsModified = false;
+}
+
+
+vtkActor* LineBuffer::GetActor() {
+    return actor;
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        LineBuffer.h
+//
+// Author:      David Borland
+//
+// Description: Interface of LineBuffer class for MatchMaker.  Draws many line segments with
+//              one polydata and one actor.  Each segment is a row with two points and an
+//              RGBA color, so objects hold a row number instead of their own line actors.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LINEBUFFER_H
+#define LINEBUFFER_H
+
+
+#include <vtkActor.h>
+#include <vtkCellArray.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkRenderer.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <vector>
+
+#include <Vec3.h>
+
+
+class LineBuffer {
+public:
+    LineBuffer(vtkRenderer* ren);
+    ~LineBuffer();
+
+    // Get a row for a new line, which starts hidden, and give it back when done
+    int AddRow();
+    void RemoveRow(int row);
+
+    // Set properties for a row
+    void SetLine(int row, const Vec3& p1, const Vec3& p2);
+    void SetColor(int row, double r, double g, double b);
+    void SetOpacity(int row, double opacity);
+    void SetVisible(int row, bool visible);
+
+    // Push any changes to the mapper.  Call once per frame.
+    void Update();
+
+    vtkActor* GetActor();
+
+private:
+    // Two points per row, patched in place
+    vtkPoints* points;
+
+    // A cell and color for each visible row, rebuilt when visibility or colors change
+    vtkCellArray* lines;
+    vtkUnsignedCharArray* colors;
+
+    vtkPolyData* polyData;
+    vtkPolyDataMapper* mapper;
+    vtkActor* actor;
+
+    vtkRenderer* renderer;
+
+    // RGBA and visibility for each row
+    std::vector<unsigned char> rowColors;
+    std::vector<bool> rowVisible;
+
+    // Rows that can be reused
+    std::vector<int> freeRows;
+
+    // Whether the cells and colors need rebuilding, or just the points
+    bool modified;
+    bool pointsModified;
+};
+
+
+#endif
\ No newline at end of file
@@ -0,0 +1,188 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        MappedFile.cpp
+//
+// Author:      David Borland
+//
+// Description: Implementation of MappedFile class for MatchMaker.  Maps a file into memory
+//              and indexes the start of each line, so ranges of lines can be handed
+//              out as pointers into the mapped file without reading or copying it.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "MappedFile.h"
+
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+MappedFile::MappedFile() {
+    data = NULL;
+    size = 0;
+
+#ifdef _WIN32
+    file = INVALID_HANDLE_VALUE;
+    mapping = NULL;
+#else
+    file = -1;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const char* fileName, bool indexLines) {
+    Close();
+
+    file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        Close();
+        return false;
+    }
+    size = (size_t)fileSize.QuadPart;
+
+    // Can't map an empty file
+    if (size > 0) {
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping == NULL) {
+            Close();
+            return false;
+        }
+
+        data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data == NULL) {
+            Close();
+            return false;
+        }
+    }
+
+    if (indexLines) BuildLineIndex();
+
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) UnmapViewOfFile(data);
+    if (mapping) CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+
+    data = NULL;
+    size = 0;
+    mapping = NULL;
+    file = INVALID_HANDLE_VALUE;
+
+    lineStarts.clear();
+}
+
+bool MappedFile::IsOpen() {
+    return file != INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool MappedFile::Open(const char* fileName, bool indexLines) {
+    Close();
+
+    file = open(fileName, O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat fileInfo;
+    if (fstat(file, &fileInfo) < 0) {
+        Close();
+        return false;
+    }
+    size = (size_t)fileInfo.st_size;
+
+    // Can't map an empty file
+    if (size > 0) {
+        void* address = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (address == MAP_FAILED) {
+            Close();
+            return false;
+        }
+        data = (const char*)address;
+
+        // The file is read from start to end
+        madvise(address, size, MADV_SEQUENTIAL);
+    }
+
+    if (indexLines) BuildLineIndex();
+
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) munmap((void*)data, size);
+    if (file >= 0) close(file);
+
+    data = NULL;
+    size = 0;
+    file = -1;
+
+    lineStarts.clear();
+}
+
+bool MappedFile::IsOpen() {
+    return file >= 0;
+}
+
+#endif
+
+
+const char* MappedFile::GetData() {
+    return data;
+}
+
+size_t MappedFile::GetSize() {
+    return size;
+}
+
+
+int MappedFile::GetNumLines() {
+    return lineStarts.empty() ? 0 : (int)lineStarts.size() - 1;
+}
+
+
+const char* MappedFile::GetLines(int first, int last, size_t& length) {
+    length = lineStarts[last] - lineStarts[first];
+
+    return data + lineStarts[first];
+}
+
+
+void MappedFile::BuildLineIndex() {
+    lineStarts.clear();
+
+    if (size == 0) return;
+
+    // Guess at the number of lines to avoid reallocating
+    lineStarts.reserve(size / 64 + 2);
+
+    const char* p = data;
+    const char* end = data + size;
+
+    while (p < end) {
+        lineStarts.push_back(p - data);
+
+        const char* newline = (const char*)memchr(p, '\n', end - p);
+        if (newline == NULL) break;
+
+        p = newline + 1;
+    }
+
+    lineStarts.push_back(size);
+}
\ No newline at end of file
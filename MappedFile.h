@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        MappedFile.h
+//
+// Author:      David Borland
+//
+// Description: Interface of MappedFile class for MatchMaker.  Maps a file into memory and
+//              indexes the start of each line, so ranges of lines can be handed out as
+//              pointers into the mapped file without reading or copying it.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include <stddef.h>
+#include <vector>
+
+
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // Binary files don't need the line index
+    bool Open(const char* fileName, bool indexLines = true);
+    void Close();
+
+    bool IsOpen();
+
+    int GetNumLines();
+
+    // The whole file
+    const char* GetData();
+    size_t GetSize();
+
+    // Lines first through last - 1, which are contiguous in the file, including newlines
+    const char* GetLines(int first, int last, size_t& length);
+
+private:
+    const char* data;
+    size_t size;
+
+    // Offset of the start of each line, plus the end of the file
+    std::vector<size_t> lineStarts;
+
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int file;
+#endif
+
+    void BuildLineIndex();
+};
+
+
+#endif
\ No newline at end of file
@@ -18,7 +18,6 @@
 
 // Create the event table for the main frame
 BEGIN_EVENT_TABLE(MainFrame, wxFrame)
-    EVT_TIMER(SocketTimerId, MainFrame::OnTimer)
     EVT_TIMER(GraphicsTimerId, MainFrame::OnTimer)
     EVT_TIMER(ResetTimerId, MainFrame::OnTimer)
 
@@ -40,6 +39,7 @@ END_EVENT_TABLE()
 // Create the event table for the Socket frame
 BEGIN_EVENT_TABLE(SocketFrame, MatchMakerFrame)
     EVT_CHECKBOX(SocketReadAllCheckBoxId, SocketFrame::OnCheckBox)
+    EVT_CHOICE(ReplaySpeedChoiceId, SocketFrame::OnChoice)
 
     EVT_SCROLL_THUMBTRACK(SocketFrame::OnScrollThumbtrack)
     EVT_SCROLL_CHANGED(SocketFrame::OnScrollChanged)
@@ -187,10 +187,6 @@ MainFrame::MainFrame(const wxString& title, const wxPoint& pos, const wxSize& si
     sizer->SetSizeHints(this);
 
 
-    // Start the socket timer
-    socketTimer = new wxTimer(this, SocketTimerId);
-    socketTimer->Start(engine->GetInitialSocketReadInterval());
-
     // Start the graphics timer
     graphicsTimer = new wxTimer(this, GraphicsTimerId);
     graphicsTimer->Start(engine->GetInitialGraphicsUpdateInterval());
@@ -205,7 +201,6 @@ MainFrame::MainFrame(const wxString& title, const wxPoint& pos, const wxSize& si
 
 MainFrame::~MainFrame() {
     // Clean up
-    delete socketTimer;
     delete graphicsTimer;
     delete resetTimer;
 
@@ -214,10 +209,7 @@ MainFrame::~MainFrame() {
 
 
 void MainFrame::OnTimer(wxTimerEvent& e) {
-    if (e.GetId() == SocketTimerId) {
-        engine->UpdateSocket();
-    }
-    else if (e.GetId() == GraphicsTimerId) {
+    if (e.GetId() == GraphicsTimerId) {
         engine->UpdateGraphics();
     }
     else if (e.GetId() == ResetTimerId) {
@@ -279,11 +271,6 @@ void MainFrame::OnRadioButton(wxCommandEvent& e) {
 }
 
 
-wxTimer* MainFrame::GetSocketTimer() {
-    return socketTimer;
-}
-
-
 wxTimer* MainFrame::GetGraphicsTimer() {
     return graphicsTimer;
 }
@@ -327,15 +314,50 @@ SocketFrame::SocketFrame(wxWindow* parent, const wxString& title, const wxPoint&
     socketReadAllCheckBox = new wxCheckBox(panel, SocketReadAllCheckBoxId, "Read all data");
     socketReadAllCheckBox->SetValue(engine->GetSocket()->GetReadAll());
 
-    socketReadIntervalSlider = new wxSlider(panel, SocketReadIntervalSliderId, mainFrame->GetSocketTimer()->GetInterval(), 1, 5000, 
+    socketReadIntervalSlider = new wxSlider(panel, SocketReadIntervalSliderId, engine->GetSocketReadInterval(), 1, 5000, 
                                         wxDefaultPosition, wxSize(200, -1), wxSL_HORIZONTAL | wxSL_LABELS);
     wxStaticBoxSizer* socketReadIntervalSizer = new wxStaticBoxSizer(wxVERTICAL, panel, "Socket read interval (ms)");
     socketReadIntervalSizer->Add(socketReadIntervalSlider, 0, wxEXPAND, 0);
 
+    // Replay speed for data files with timestamps.  144x plays a day in 10 minutes.
+    double speeds[] = { 0.0, 0.5, 1.0, 2.0, 5.0, 10.0, 50.0, 100.0, 144.0, 500.0, 1000.0 };
+    replaySpeeds.assign(speeds, speeds + sizeof(speeds) / sizeof(speeds[0]));
+
+    replaySpeedChoice = new wxChoice(panel, ReplaySpeedChoiceId);
+    int selection = -1;
+    for (int i = 0; i < (int)replaySpeeds.size(); i++) {
+        if (replaySpeeds[i] == 0.0) replaySpeedChoice->Append("Ignore timestamps");
+        else replaySpeedChoice->Append(wxString::Format("%gx", replaySpeeds[i]));
+
+        if (replaySpeeds[i] == engine->GetReplaySpeed()) selection = i;
+    }
+    if (selection < 0) {
+        // Speed from the configuration file that isn't in the list
+        replaySpeeds.push_back(engine->GetReplaySpeed());
+        replaySpeedChoice->Append(wxString::Format("%gx", engine->GetReplaySpeed()));
+        selection = (int)replaySpeeds.size() - 1;
+    }
+    replaySpeedChoice->SetSelection(selection);
+
+    wxStaticBoxSizer* replaySpeedSizer = new wxStaticBoxSizer(wxVERTICAL, panel, "Replay speed");
+    replaySpeedSizer->Add(replaySpeedChoice, 0, wxEXPAND, 0);
+
+    // Seek in the data file.  The model is recreated when the slider is released.
+    seekSlider = new wxSlider(panel, SeekSliderId, 0, 0, 1000, 
+                              wxDefaultPosition, wxSize(200, -1), wxSL_HORIZONTAL);
+    seekLabel = new wxStaticText(panel, wxID_ANY, "");
+    UpdateSeekLabel(0);
+
+    wxStaticBoxSizer* seekSizer = new wxStaticBoxSizer(wxVERTICAL, panel, "Replay position");
+    seekSizer->Add(seekSlider, 0, wxEXPAND, 0);
+    seekSizer->Add(seekLabel, 0, wxEXPAND, 0);
+
     wxBoxSizer* sizer = new wxBoxSizer(wxVERTICAL);
 
     sizer->Add(socketReadAllCheckBox, 0, wxEXPAND | wxALL, border);
     sizer->Add(socketReadIntervalSizer, 0, wxEXPAND | wxALL, border);
+    sizer->Add(replaySpeedSizer, 0, wxEXPAND | wxALL, border);
+    sizer->Add(seekSizer, 0, wxEXPAND | wxALL, border);
 
     panel->SetSizer(sizer);
     sizer->SetSizeHints(this);
@@ -349,16 +371,45 @@ void SocketFrame::OnCheckBox(wxCommandEvent& e) {
 }
 
 
+void SocketFrame::OnChoice(wxCommandEvent& e) {
+    if (e.GetId() == ReplaySpeedChoiceId) {
+        engine->SetReplaySpeed(replaySpeeds[e.GetSelection()]);
+    }
+}
+
+
 void SocketFrame::OnScrollThumbtrack(wxScrollEvent& e) {
     if (e.GetId() == SocketReadIntervalSliderId) {
-        mainFrame->GetSocketTimer()->Start(e.GetInt());
+        engine->SetSocketReadInterval(e.GetInt());
+    }
+    else if (e.GetId() == SeekSliderId) {
+        UpdateSeekLabel(e.GetInt());
     }
 }
 
 
 void SocketFrame::OnScrollChanged(wxScrollEvent& e) {
     if (e.GetId() == SocketReadIntervalSliderId) {
-        mainFrame->GetSocketTimer()->Start(e.GetInt());
+        engine->SetSocketReadInterval(e.GetInt());
+    }
+    else if (e.GetId() == SeekSliderId) {
+        UpdateSeekLabel(e.GetInt());
+
+        engine->Seek(e.GetInt() / 1000.0);
+    }
+}
+
+
+void SocketFrame::UpdateSeekLabel(int position) {
+    // Show the time into the recording if there are timestamps
+    double start, end;
+    if (engine->GetReplayTimeRange(start, end)) {
+        int seconds = (int)(position / 1000.0 * (end - start));
+
+        seekLabel->SetLabel(wxString::Format("%d:%02d:%02d", seconds / 3600, (seconds / 60) % 60, seconds % 60));
+    }
+    else {
+        seekLabel->SetLabel(wxString::Format("%.1f%%", position / 10.0));
     }
 }
 
@@ -525,6 +576,8 @@ void GraphicsFrame::OnButton(wxCommandEvent& e) {
     if (e.GetId() == ResetSiteSpindlesButtonId) {
         engine->GetSiteList()->ResetSpindles();
     }
+
+    engine->RequestRender();
 }
 
 void GraphicsFrame::OnRadioButton(wxCommandEvent& e) {
@@ -543,6 +596,8 @@ void GraphicsFrame::OnRadioButton(wxCommandEvent& e) {
         engine->GetRenderPipeline()->ShowStatusLegend(true);
         engine->GetRenderPipeline()->ShowScienceLegend(true);
     }
+
+    engine->RequestRender();
 }
 
 void GraphicsFrame::OnCheckBox(wxCommandEvent& e) {
@@ -573,6 +628,8 @@ void GraphicsFrame::OnCheckBox(wxCommandEvent& e) {
     else if (e.GetId() == RotateLogosCheckBoxId) {
         engine->GetRenderPipeline()->RotateLogos(e.IsChecked());
     }
+
+    engine->RequestRender();
 }
 
 
@@ -603,6 +660,8 @@ void GraphicsFrame::OnScrollThumbtrack(wxScrollEvent& e) {
     else if (e.GetId() == FadedOpacitySliderId) {
         engine->GetWorkflowList()->SetFadedOpacity((double)e.GetInt() / 100.0);
     }
+
+    engine->RequestRender();
 }
 
 
@@ -630,4 +689,6 @@ void GraphicsFrame::OnScrollChanged(wxScrollEvent& e) {
     else if (e.GetId() == FadedOpacitySliderId) {
         engine->GetWorkflowList()->SetFadedOpacity((double)e.GetInt() / 100.0);
     }
+
+    engine->RequestRender();
 }
@@ -27,7 +27,6 @@ class GraphicsFrame;
 // Event IDs
 enum {
     // Timer
-    SocketTimerId,
     GraphicsTimerId,
     ResetTimerId,
 
@@ -42,6 +41,8 @@ enum {
 
     SocketReadAllCheckBoxId,
     SocketReadIntervalSliderId,
+    ReplaySpeedChoiceId,
+    SeekSliderId,
 
     GraphicsUpdateIntervalSliderId,
     ObjectRadiusSliderId,
@@ -101,12 +102,10 @@ public:
     void OnRadioButton(wxCommandEvent& e);
 
     // Get Timers
-    wxTimer* GetSocketTimer();
     wxTimer* GetGraphicsTimer();
 
 private:
-    // Timers
-    wxTimer* socketTimer;
+    // Timers.  The socket is read on its own thread.
     wxTimer* graphicsTimer;
     wxTimer* resetTimer;
 
@@ -188,12 +187,23 @@ public:
     SocketFrame(wxWindow* parent, const wxString& title, const wxPoint& pos, const wxSize& size, Engine* engine);
 
     void OnCheckBox(wxCommandEvent& e);
+    void OnChoice(wxCommandEvent& e);
     void OnScrollThumbtrack(wxScrollEvent& e);
     void OnScrollChanged(wxScrollEvent& e);
 
 private:
     wxCheckBox* socketReadAllCheckBox;
     wxSlider* socketReadIntervalSlider;
+    wxChoice* replaySpeedChoice;
+
+    // Speeds listed in the replay speed choice
+    std::vector<double> replaySpeeds;
+
+    // Position in the data file, in tenths of a percent
+    wxSlider* seekSlider;
+    wxStaticText* seekLabel;
+
+    void UpdateSeekLabel(int position);
 
     DECLARE_EVENT_TABLE()
 };
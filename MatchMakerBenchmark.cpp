@@ -0,0 +1,402 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        MatchMakerBenchmark.cpp
+//
+// Author:      David Borland
+//
+// Description: Headless ingest benchmark for MatchMaker.  Feeds events one line at a time
+//              through the EventParser and the job, site, workflow, and network connection
+//              lists, with a renderer that is never rendered.  Reports events per second,
+//              p50 and p99 per-event latency, and peak memory use.
+//
+//              Events are generated for each number of concurrent jobs, or replayed from a
+//              recorded data file, either text or binary.
+//
+//              With -seek, also checks that seeking in a timestamped text data file and in
+//              its binary conversion from MatchMakerConvert recreate the same state.
+//
+//              Usage: MatchMakerBenchmark [-scales 1000,10000,100000] [-events 100000]
+//                                         [-seed 1] [-update 0] [-file Data/OSG.data]
+//                                         [-seek Data/OSG.mmev]
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "BinaryEvent.h"
+#include "BinaryFileSocket.h"
+#include "EventGenerator.h"
+#include "EventParser.h"
+#include "JobList.h"
+#include "NetworkConnectionList.h"
+#include "Projector.h"
+#include "ReplayState.h"
+#include "SiteList.h"
+#include "TextFileSocket.h"
+#include "WorkflowList.h"
+
+#include <vtkRenderer.h>
+
+#include <wx/log.h>
+
+#include <windows.h>
+#include <psapi.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+// Options
+struct BenchmarkOptions {
+    std::vector<int> scales;
+    int numEvents;
+    unsigned int seed;
+    int updateInterval;
+    std::string fileName;
+    std::string seekFileName;
+};
+
+
+bool ParseOptions(int argc, char* argv[], BenchmarkOptions& options) {
+    // Defaults
+    options.numEvents = 100000;
+    options.seed = 1;
+    options.updateInterval = 0;
+
+    std::string scales = "1000,10000,100000";
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            printf("Missing value for %s\n", argv[i]);
+            return false;
+        }
+
+        const char* value = argv[++i];
+
+        if (strcmp(argv[i - 1], "-scales") == 0) scales = value;
+        else if (strcmp(argv[i - 1], "-events") == 0) options.numEvents = atoi(value);
+        else if (strcmp(argv[i - 1], "-seed") == 0) options.seed = (unsigned int)atoi(value);
+        else if (strcmp(argv[i - 1], "-update") == 0) options.updateInterval = atoi(value);
+        else if (strcmp(argv[i - 1], "-file") == 0) options.fileName = value;
+        else if (strcmp(argv[i - 1], "-seek") == 0) options.seekFileName = value;
+        else {
+            printf("Unknown option: %s\n", argv[i - 1]);
+            return false;
+        }
+    }
+
+    std::stringstream ss(scales);
+    std::string scale;
+    while (std::getline(ss, scale, ',')) {
+        if (atoi(scale.c_str()) > 0) options.scales.push_back(atoi(scale.c_str()));
+    }
+
+    return true;
+}
+
+
+// The model, as set up by the Engine, but without a render window
+class Model {
+public:
+    Model() {
+        renderer = vtkRenderer::New();
+        legendRenderer = vtkRenderer::New();
+
+        // Same map extents as the RenderPipeline
+        double mapExtents[4];
+        mapExtents[0] = Projector::ProjectLongitude(-125.0);
+        mapExtents[1] = Projector::ProjectLatitude(23.5);
+        mapExtents[2] = Projector::ProjectLongitude(-66.5);
+        mapExtents[3] = Projector::ProjectLatitude(50.0);
+
+        double y = mapExtents[1] - (mapExtents[3] - mapExtents[1]) * 0.1;
+
+        siteList = new SiteList(renderer, legendRenderer, true);
+        siteList->SetMapExtents(mapExtents);
+        siteList->SetUnknownPos(Vec2(mapExtents[0] + (mapExtents[2] - mapExtents[0]) * 0.25, y));
+        siteList->SetOffTheMapPos(Vec2(mapExtents[0] + (mapExtents[2] - mapExtents[0]) * 0.75, y));
+
+        Site* matching = siteList->Get("MATCHING");
+        Site* done = siteList->Get("DONE");
+
+        jobList = new JobList(matching, static_cast<DoneSite*>(done), renderer, true);
+        workflowList = new WorkflowList(legendRenderer, true);
+        networkConnectionList = new NetworkConnectionList(renderer, true);
+
+        parser = new EventParser(jobList, siteList, workflowList, networkConnectionList);
+    }
+
+    ~Model() {
+        delete parser;
+        delete networkConnectionList;
+        delete workflowList;
+        delete jobList;
+        delete siteList;
+
+        renderer->Delete();
+        legendRenderer->Delete();
+    }
+
+    vtkRenderer* renderer;
+    vtkRenderer* legendRenderer;
+
+    JobList* jobList;
+    SiteList* siteList;
+    WorkflowList* workflowList;
+    NetworkConnectionList* networkConnectionList;
+
+    EventParser* parser;
+};
+
+
+double GetSeconds() {
+    static LARGE_INTEGER frequency;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+
+    LARGE_INTEGER count;
+    QueryPerformanceCounter(&count);
+
+    return (double)count.QuadPart / (double)frequency.QuadPart;
+}
+
+
+double GetPeakMemoryMB() {
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0.0;
+
+    return (double)counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+}
+
+
+// Split data into lines, keeping the newlines
+void SplitLines(const std::string& s, std::vector<std::string>& lines) {
+    std::string::size_type start = 0;
+    while (start < s.size()) {
+        std::string::size_type end = s.find('\n', start);
+        if (end == std::string::npos) end = s.size() - 1;
+
+        lines.push_back(s.substr(start, end - start + 1));
+        start = end + 1;
+    }
+}
+
+
+// Split binary data into events, skipping the header
+void SplitEvents(const std::string& s, std::vector<std::string>& events) {
+    std::string::size_type start = BinaryEvent::HeaderSize;
+    while (start < s.size()) {
+        bool hasTimestamp;
+        double timestamp;
+        size_t size = BinaryEvent::EventSize(s.c_str() + start, s.size() - start, hasTimestamp, timestamp);
+        if (size == 0) break;
+
+        events.push_back(s.substr(start, size));
+        start += size;
+    }
+}
+
+
+// Parse each line on its own, timing each one
+void Run(const char* name, Model& model, const std::vector<std::string>& lines, bool binary, int updateInterval) {
+    std::vector<double> latencies;
+    latencies.reserve(lines.size());
+
+    std::string line;
+
+    double startTime = GetSeconds();
+
+    for (int i = 0; i < (int)lines.size(); i++) {
+        line = lines[i];
+
+        double t = GetSeconds();
+        if (binary) model.parser->ParseBinary(line);
+        else model.parser->Parse(line);
+        model.parser->Flush();
+        latencies.push_back(GetSeconds() - t);
+
+        // Optionally include the per-frame model update
+        if (updateInterval > 0 && (i + 1) % updateInterval == 0) {
+            model.siteList->Arrange();
+            model.jobList->UpdatePositions();
+        }
+    }
+
+    double totalTime = GetSeconds() - startTime;
+
+    if (latencies.empty()) {
+        printf("%-12s no events\n", name);
+        return;
+    }
+
+    std::vector<double>::iterator p50 = latencies.begin() + latencies.size() / 2;
+    std::nth_element(latencies.begin(), p50, latencies.end());
+    double p50Time = *p50;
+
+    std::vector<double>::iterator p99 = latencies.begin() + (latencies.size() * 99) / 100;
+    std::nth_element(latencies.begin(), p99, latencies.end());
+    double p99Time = *p99;
+
+    printf("%-12s %10d %14.0f %12.2f %12.2f %14.1f\n",
+           name, (int)lines.size(), (double)lines.size() / totalTime,
+           p50Time * 1.0e6, p99Time * 1.0e6, GetPeakMemoryMB());
+}
+
+
+// Decode binary state data as text, so it can be compared with the text file's state
+void DecodeState(const std::string& data, std::string& s) {
+    std::vector<std::string> strings;
+
+    size_t position = 0;
+    while (position < data.size()) {
+        size_t recordSize = BinaryEvent::RecordSize(data.c_str() + position, data.size() - position);
+        if (recordSize == 0) break;
+
+        if (data[position] == BinaryEvent::OpString) {
+            unsigned int id = BinaryEvent::ReadUInt(data.c_str() + position + 1);
+
+            if (id >= strings.size()) strings.resize(id + 1);
+            strings[id].assign(data.c_str() + position + 7, recordSize - 7);
+        }
+
+        position += recordSize;
+    }
+
+    ReplayState state;
+    state.ParseBinary(data.c_str(), data.size(), strings);
+
+    s.clear();
+    state.Write(s);
+}
+
+
+// Seek through a text file and its binary conversion, and compare the states
+bool CheckSeek(const std::string& textFileName, const std::string& binaryFileName) {
+    TextFileSocket text;
+    BinaryFileSocket binary;
+
+    if (!text.Init(textFileName.c_str()) || !binary.Init(binaryFileName.c_str())) return false;
+
+    double textStart, textEnd, binaryStart, binaryEnd;
+    bool textTimes = text.GetTimeRange(textStart, textEnd);
+    bool binaryTimes = binary.GetTimeRange(binaryStart, binaryEnd);
+
+    // Lines the converter leaves out would throw off seeking by line, so only seek by time
+    if (!textTimes) {
+        printf("Seek check: %s has no timestamps\n", textFileName.c_str());
+        return false;
+    }
+
+    if (!binaryTimes || textStart != binaryStart || textEnd != binaryEnd) {
+        printf("Seek check: time ranges differ\n");
+        return false;
+    }
+
+    // Seek forward, then back, so snapshots are used both ways
+    const int numPositions = 10;
+    bool same = true;
+
+    std::string textState;
+    std::string binaryState;
+    std::string decodedState;
+
+    for (int i = 0; i <= numPositions * 2; i++) {
+        double position = (double)(i <= numPositions ? i : numPositions * 2 - i) / numPositions;
+
+        text.Seek(position, textState);
+        binary.Seek(position, binaryState);
+        DecodeState(binaryState, decodedState);
+
+        if (decodedState != textState) {
+            printf("Seek check: states differ at %.1f\n", position);
+            same = false;
+        }
+    }
+
+    if (same) printf("Seek check: %s and %s match\n", textFileName.c_str(), binaryFileName.c_str());
+
+    return same;
+}
+
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    if (!ParseOptions(argc, argv, options)) return 1;
+
+    // Don't pop up message boxes
+    delete wxLog::SetActiveTarget(new wxLogStderr());
+
+    if (!options.seekFileName.empty()) {
+        if (options.fileName.empty()) {
+            printf("-seek needs the text data file given with -file\n");
+            return 1;
+        }
+
+        if (!CheckSeek(options.fileName, options.seekFileName)) return 1;
+    }
+
+    printf("%-12s %10s %14s %12s %12s %14s\n", "Jobs", "Events", "Events/sec", "p50 (us)", "p99 (us)", "Peak RSS (MB)");
+
+    if (!options.fileName.empty()) {
+        // Replay a recorded stream
+        std::ifstream file(options.fileName.c_str(), std::ios::in | std::ios::binary);
+        if (!file) {
+            printf("Can't open %s\n", options.fileName.c_str());
+            return 1;
+        }
+
+        std::stringstream ss;
+        ss << file.rdbuf();
+
+        std::string data = ss.str();
+        bool binary = BinaryEvent::IsBinary(data.c_str(), data.size());
+
+        std::vector<std::string> lines;
+        if (binary) SplitEvents(data, lines);
+        else SplitLines(data, lines);
+
+        Model model;
+        Run(binary ? "binary file" : "file", model, lines, binary, options.updateInterval);
+
+        return 0;
+    }
+
+    // Generated streams, from the smallest scale up so the peak memory applies to each scale
+    std::sort(options.scales.begin(), options.scales.end());
+
+    for (int i = 0; i < (int)options.scales.size(); i++) {
+        int scale = options.scales[i];
+
+        EventGenerator generator(scale / 100 + 10, scale / 1000 + 5, scale, options.seed);
+
+        Model model;
+
+        // Fill the model up to the number of concurrent jobs without timing
+        std::string s;
+        generator.GenerateSetup(s);
+        while (generator.GetNumActiveJobs() < scale) {
+            generator.Generate(1000, s);
+        }
+        model.parser->Parse(s);
+        model.parser->Flush();
+
+        // Generate the timed events up front, so only parsing is timed
+        s.clear();
+        generator.Generate(options.numEvents, s);
+
+        std::vector<std::string> lines;
+        SplitLines(s, lines);
+        s.clear();
+
+        char name[32];
+        sprintf_s(name, sizeof(name), "%d", scale);
+        Run(name, model, lines, false, options.updateInterval);
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        MatchMakerConvert.cpp
+//
+// Author:      David Borland
+//
+// Description: Converts a MatchMaker text data file to the binary event format.  Lines that
+//              don't change anything, such as pings and local IDs, and invalid lines are
+//              left out.  Timestamps are kept.
+//
+//              Usage: MatchMakerConvert input.data output.mmev
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "BinaryEvent.h"
+#include "MappedFile.h"
+#include "Tokenizer.h"
+
+#include <stdio.h>
+
+#include <string>
+
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        printf("Usage: MatchMakerConvert input.data output.mmev\n");
+        return 1;
+    }
+
+    MappedFile input;
+    if (!input.Open(argv[1])) {
+        printf("Can't open %s\n", argv[1]);
+        return 1;
+    }
+
+    FILE* output = fopen(argv[2], "wb");
+    if (!output) {
+        printf("Can't open %s\n", argv[2]);
+        return 1;
+    }
+
+    BinaryEventWriter writer;
+    std::string s;
+    writer.WriteHeader(s);
+
+    int numConverted = 0;
+    int numSkipped = 0;
+
+    // Tokenize a chunk of lines at a time and write the output in blocks, so neither the
+    // input nor the output has to fit in one piece
+    const int chunkLines = 65536;
+    const std::string::size_type blockSize = 1 << 20;
+
+    unsigned long long outputSize = 0;
+    bool written = true;
+
+    int numLines = input.GetNumLines();
+    for (int first = 0; first < numLines && written; first += chunkLines) {
+        int last = first + chunkLines < numLines ? first + chunkLines : numLines;
+
+        size_t length;
+        const char* lines = input.GetLines(first, last, length);
+
+        Tokenizer tokens(lines, (int)length);
+        while (tokens.NextLine()) {
+            // Pings and local IDs are skipped without counting them
+            if (tokens.GetNumTokens() == 1 && tokens[0] == "ping") continue;
+            if (tokens.GetNumTokens() == 4 && tokens[2] == "localid") continue;
+
+            // Write the timestamp right before its event
+            std::string::size_type start = s.size();
+            if (tokens.HasTimestamp()) writer.WriteTimestamp(tokens.GetTimestamp(), s);
+
+            if (writer.WriteLine(tokens, s)) {
+                numConverted++;
+            }
+            else {
+                s.resize(start);
+                numSkipped++;
+            }
+
+            if (s.size() >= blockSize) {
+                written = fwrite(s.data(), 1, s.size(), output) == s.size();
+                outputSize += s.size();
+                s.clear();
+
+                if (!written) break;
+            }
+        }
+    }
+
+    written = written && fwrite(s.data(), 1, s.size(), output) == s.size();
+    outputSize += s.size();
+
+    written = fclose(output) == 0 && written;
+
+    if (!written) {
+        printf("Error writing %s\n", argv[2]);
+        return 1;
+    }
+
+    printf("Converted %d events, skipped %d lines\n", numConverted, numSkipped);
+    printf("%llu bytes to %llu bytes\n", (unsigned long long)input.GetSize(), outputSize);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,210 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        MatchMakerGenerator.cpp
+//
+// Author:      David Borland
+//
+// Description: Serves synthetic MatchMaker events over a loopback TCP port, for load testing.
+//              MatchMaker connects to it like any other host.  Each connection gets the same
+//              events for the same options.
+//
+//              Usage: MatchMakerGenerator [-port 9001] [-rate 1000] [-sites 50] [-workflows 20]
+//                                         [-jobs 1000] [-seed 1] [-failed 0.1] [-transfers 0.2]
+//                                         [-science 0.8] [-runsteps 10] [-siteupdates 0.01]
+//                                         [-total 0]
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "EventGenerator.h"
+
+#include <winsock.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+
+// Options
+struct GeneratorOptions {
+    unsigned short port;
+    int rate;
+    int numSites;
+    int numWorkflows;
+    int maxActiveJobs;
+    unsigned int seed;
+    double failedFraction;
+    double dataTransferFraction;
+    double scienceFraction;
+    int maxRunSteps;
+    double siteUpdateFraction;
+    int totalLines;
+};
+
+
+bool ParseOptions(int argc, char* argv[], GeneratorOptions& options) {
+    // Defaults
+    options.port = 9001;
+    options.rate = 1000;
+    options.numSites = 50;
+    options.numWorkflows = 20;
+    options.maxActiveJobs = 1000;
+    options.seed = 1;
+    options.failedFraction = 0.1;
+    options.dataTransferFraction = 0.2;
+    options.scienceFraction = 0.8;
+    options.maxRunSteps = 10;
+    options.siteUpdateFraction = 0.01;
+    options.totalLines = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            printf("Missing value for %s\n", argv[i]);
+            return false;
+        }
+
+        const char* value = argv[++i];
+
+        if (strcmp(argv[i - 1], "-port") == 0) options.port = (unsigned short)atoi(value);
+        else if (strcmp(argv[i - 1], "-rate") == 0) options.rate = atoi(value);
+        else if (strcmp(argv[i - 1], "-sites") == 0) options.numSites = atoi(value);
+        else if (strcmp(argv[i - 1], "-workflows") == 0) options.numWorkflows = atoi(value);
+        else if (strcmp(argv[i - 1], "-jobs") == 0) options.maxActiveJobs = atoi(value);
+        else if (strcmp(argv[i - 1], "-seed") == 0) options.seed = (unsigned int)atoi(value);
+        else if (strcmp(argv[i - 1], "-failed") == 0) options.failedFraction = atof(value);
+        else if (strcmp(argv[i - 1], "-transfers") == 0) options.dataTransferFraction = atof(value);
+        else if (strcmp(argv[i - 1], "-science") == 0) options.scienceFraction = atof(value);
+        else if (strcmp(argv[i - 1], "-runsteps") == 0) options.maxRunSteps = atoi(value);
+        else if (strcmp(argv[i - 1], "-siteupdates") == 0) options.siteUpdateFraction = atof(value);
+        else if (strcmp(argv[i - 1], "-total") == 0) options.totalLines = atoi(value);
+        else {
+            printf("Unknown option: %s\n", argv[i - 1]);
+            return false;
+        }
+    }
+
+    if (options.rate < 1) options.rate = 1;
+
+    return true;
+}
+
+
+bool SendAll(SOCKET sock, const std::string& s) {
+    int sent = 0;
+    while (sent < (int)s.size()) {
+        int n = send(sock, s.c_str() + sent, (int)s.size() - sent, 0);
+        if (n == SOCKET_ERROR) return false;
+
+        sent += n;
+    }
+
+    return true;
+}
+
+
+void Serve(SOCKET client, const GeneratorOptions& options) {
+    // Start from the same state for every connection
+    EventGenerator generator(options.numSites, options.numWorkflows, options.maxActiveJobs, options.seed);
+    generator.SetFailedFraction(options.failedFraction);
+    generator.SetDataTransferFraction(options.dataTransferFraction);
+    generator.SetScienceFraction(options.scienceFraction);
+    generator.SetMaxRunSteps(options.maxRunSteps);
+    generator.SetSiteUpdateFraction(options.siteUpdateFraction);
+
+    std::string s;
+    generator.GenerateSetup(s);
+    if (!SendAll(client, s)) return;
+
+    int totalSent = 0;
+    DWORD startTime = GetTickCount();
+    DWORD reportTime = startTime;
+
+    while (options.totalLines <= 0 || totalSent < options.totalLines) {
+        // Send however many lines are due at this rate
+        DWORD now = GetTickCount();
+        int due = (int)((double)(now - startTime) * options.rate / 1000.0) - totalSent;
+
+        if (options.totalLines > 0 && totalSent + due > options.totalLines) {
+            due = options.totalLines - totalSent;
+        }
+
+        if (due > 0) {
+            s.clear();
+            totalSent += generator.Generate(due, s);
+
+            if (!SendAll(client, s)) {
+                printf("Client disconnected\n");
+                return;
+            }
+        }
+
+        // Report once a second
+        if (now - reportTime >= 1000) {
+            printf("Sent %d lines, %d active jobs, %d jobs created\n",
+                   totalSent, generator.GetNumActiveJobs(), generator.GetNumJobsCreated());
+            reportTime = now;
+        }
+
+        Sleep(10);
+    }
+
+    printf("Sent %d lines\n", totalSent);
+}
+
+
+int main(int argc, char* argv[]) {
+    GeneratorOptions options;
+    if (!ParseOptions(argc, argv, options)) return 1;
+
+    // Initialize the socket library
+    WSADATA info;
+    if (WSAStartup(MAKEWORD(1, 1), &info) != 0) {
+        printf("Cannot initialize WinSock.\n");
+        return 1;
+    }
+
+    SOCKET server = socket(AF_INET, SOCK_STREAM, 0);
+    if (server == INVALID_SOCKET) {
+        printf("Can't create socket.\n");
+        WSACleanup();
+        return 1;
+    }
+
+    // Only listen on the loopback address
+    struct sockaddr_in socketAddress;
+    memset(&socketAddress, 0, sizeof(socketAddress));
+    socketAddress.sin_family = AF_INET;
+    socketAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socketAddress.sin_port = htons(options.port);
+
+    if (bind(server, (struct sockaddr*)&socketAddress, sizeof(socketAddress)) == SOCKET_ERROR ||
+        listen(server, 1) == SOCKET_ERROR) {
+        printf("Can't listen on port %d.\n", options.port);
+        closesocket(server);
+        WSACleanup();
+        return 1;
+    }
+
+    printf("Serving %d lines per second on localhost:%d\n", options.rate, options.port);
+
+    // Serve one client at a time
+    while (true) {
+        SOCKET client = accept(server, NULL, NULL);
+        if (client == INVALID_SOCKET) {
+            printf("Error accepting connection.\n");
+            break;
+        }
+
+        printf("Client connected\n");
+
+        Serve(client, options);
+
+        closesocket(client);
+    }
+
+    closesocket(server);
+    WSACleanup();
+
+    return 0;
+}
\ No newline at end of file
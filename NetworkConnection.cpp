@@ -52,7 +52,8 @@ NetworkConnection::~NetworkConnection() {
 }
 
 
-void NetworkConnection::SetBandwidth(double networkBandwidth) {
+bool NetworkConnection::SetBandwidth(double networkBandwidth) {
+    bool shown = bandwidth > 0;
     bandwidth = networkBandwidth;
 
     // Ignore negative bandwidths
@@ -68,10 +69,17 @@ void NetworkConnection::SetBandwidth(double networkBandwidth) {
         width = width < minRadius * 2.0 ? minRadius * 2.0 : width;
         width = width > maxRadius * 2.0 ? maxRadius * 2.0 : width;
 
+        // Only a new connection or a different width needs drawing again
+        bool changed = !shown || actor->GetScale()[1] != width;
+
         actor->GetScale()[1] = width;
 
         renderer->AddViewProp(actor);
+
+        return changed;
     }
+
+    return false;
 }
 
 
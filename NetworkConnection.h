@@ -33,7 +33,8 @@ public:
     NetworkConnection(Site* sourceSite, Site* destSite, vtkRenderer* ren, bool darkBackground);
     ~NetworkConnection();
 
-    void SetBandwidth(double networkBandwidth);
+    // Returns true if the connection is drawn differently
+    bool SetBandwidth(double networkBandwidth);
 
     const std::string& GetSourceID();
     const std::string& GetDestID();
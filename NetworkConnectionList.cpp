@@ -23,18 +23,18 @@ NetworkConnectionList::~NetworkConnectionList() {
 
 
 NetworkConnection* NetworkConnectionList::Get(Site* source, Site* dest) {
-    // Search for source and destination names
-    for (int i = 0; i < (int)connections.size(); i++) {
-        if ((connections[i]->GetSourceID() == source->GetID() && connections[i]->GetDestID() == dest->GetID()) ||
-            (connections[i]->GetSourceID() == dest->GetID() && connections[i]->GetDestID() == source->GetID())) {
-            return connections[i];
-        }
+    // Search for source and destination, in either direction
+    SitePair sites = MakeSitePair(source, dest);
+    std::unordered_map<SitePair, NetworkConnection*, SitePairHash>::iterator it = connectionIndex.find(sites);
+    if (it != connectionIndex.end()) {
+        return it->second;
     }
 
     // It's not there, so add it
     connections.push_back(new NetworkConnection(source, dest, renderer, darkBackground));
     source->AddNetworkConnection(connections.back());
     dest->AddNetworkConnection(connections.back());
+    connectionIndex[sites] = connections.back();
 
     return connections.back();
 }
@@ -52,4 +52,11 @@ void NetworkConnectionList::Reset() {
         delete connections[i];
     }
     connections.clear();
+    connectionIndex.clear();
+}
+
+
+NetworkConnectionList::SitePair NetworkConnectionList::MakeSitePair(Site* site1, Site* site2) {
+    if (std::less<Site*>()(site2, site1)) return SitePair(site2, site1);
+    return SitePair(site1, site2);
 }
\ No newline at end of file
@@ -17,9 +17,23 @@
 
 #include <vtkRenderer.h>
 
+#include <functional>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 
+// Hash for a pair of sites
+struct SitePairHash {
+    size_t operator()(const std::pair<Site*, Site*>& sites) const {
+        size_t h1 = std::hash<Site*>()(sites.first);
+        size_t h2 = std::hash<Site*>()(sites.second);
+
+        return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
+    }
+};
+
+
 class NetworkConnectionList {
 public:
     NetworkConnectionList(vtkRenderer* ren, bool useDarkBackground);
@@ -35,6 +49,12 @@ public:
 private:
     std::vector<NetworkConnection*> connections;
 
+    // Connections by pair of sites, with the lower pointer first so either direction matches
+    typedef std::pair<Site*, Site*> SitePair;
+    std::unordered_map<SitePair, NetworkConnection*, SitePairHash> connectionIndex;
+
+    SitePair MakeSitePair(Site* site1, Site* site2);
+
     bool darkBackground;
 
     vtkRenderer* renderer;
@@ -97,15 +97,29 @@ void RenderPipeline::Render() {
 }
 
 
-void RenderPipeline::Update() {
+bool RenderPipeline::Update() {
+    bool changed = false;
+
     if (showLogos && rotateLogos) {
         for (int i = 0; i < (int)logoActors.size(); i++) {
             if (logoActors[i]->GetOrientation()[1] > 90.0) logoActors[i]->SetOrientation(0.0, 270.0, 0.0);
             else logoActors[i]->RotateY(1.0);
 
             logoRenderers[i]->ResetCameraClippingRange();
+
+            changed = true;
         }
     }
+
+    // Keep the frame rate steady when recording
+    if (recordingMovie) changed = true;
+
+    return changed;
+}
+
+
+double RenderPipeline::GetCameraDistance() {
+    return renderer->GetActiveCamera()->GetDistance() / initialCameraDistance;
 }
 
 
@@ -440,6 +454,8 @@ void RenderPipeline::SetInitialView() {
     renderer->GetActiveCamera()->Dolly(1.4);
     renderer->ResetCameraClippingRange();
 
+    initialCameraDistance = renderer->GetActiveCamera()->GetDistance();
+
 
     // Prime the interactor
     vtkInteractorStyle* style = static_cast<vtkInteractorStyle*>(interactor->GetInteractorStyle());
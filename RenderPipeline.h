@@ -40,7 +40,12 @@ public:
     vtkRenderWindowInteractor* GetInteractor();
 
     void Render();
-    void Update();
+
+    // Returns true if anything animated, so a render is needed
+    bool Update();
+
+    // Distance from the camera to its focal point, as a multiple of the starting distance
+    double GetCameraDistance();
 
     vtkRenderer* GetRenderer();
     vtkRenderer* GetLegendRenderer();
@@ -97,6 +102,8 @@ private:
 
     bool darkBackground;
 
+    double initialCameraDistance;
+
     // Legend
     vtkLegendBoxActor* statusLegend;
     vtkLegendBoxActor* scienceLegend;
@@ -0,0 +1,427 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        ReplayState.cpp
+//
+// Author:      David Borland
+//
+// Description: Implementation of ReplayState class for MatchMaker.  Keeps the latest state of
+//              each job, site, workflow, and network connection in a replayed data file,
+//              without any graphics, so it can be copied as a snapshot and written out as
+//              events that recreate the model.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "ReplayState.h"
+
+#include <stdio.h>
+
+#include <utility>
+
+
+ReplayState::ReplayState() {
+}
+
+ReplayState::~ReplayState() {
+}
+
+
+void ReplayState::ParseLines(const char* data, int length) {
+    Tokenizer tokens(data, length);
+
+    // Follows EventParser::Parse, but only keeps the results
+    while (tokens.NextLine()) {
+        int numTokens = tokens.GetNumTokens();
+
+        if (numTokens == 1 && tokens[0] == "EOF") {
+            Reset();
+            continue;
+        }
+
+        if (tokens.TooManyTokens() || numTokens < 4) continue;
+
+        for (int i = 1; i < numTokens; i++) {
+            tokens[i].CopyTo(tokenStrings[i]);
+        }
+
+        if (tokens[0] == "job" && (numTokens == 4 || numTokens == 6 || numTokens == 10)) {
+            JobState& job = GetJob(tokenStrings[1]);
+            const Token& command = tokens[2];
+
+            if (command == "state") {
+                const std::string& state = tokenStrings[3];
+
+                if (state != "MATCHING" && state != "SUBMITTING" && state != "QUEUED" &&
+                    state != "RUNNING" && state != "DONE" && state != "FAILED") continue;
+
+                job.state = state;
+
+                if (numTokens == 6 && tokens[4] == "science") job.science = tokenStrings[5];
+            }
+            else if (command == "tosite") {
+                GetSite(tokenStrings[3]);
+                job.site = tokenStrings[3];
+            }
+            else if (command == "workflow") {
+                GetWorkflow(tokenStrings[3]);
+                job.workflow = tokenStrings[3];
+            }
+            else if (command == "job_name") {
+                job.name = tokenStrings[3];
+            }
+            else if (command == "data_source" && numTokens == 10) {
+                // Only the sites are kept.  Transfers finish on their own.
+                if (tokens[3] != tokens[5] && tokens[7].ToDouble() > 0.0) {
+                    GetSite(tokenStrings[3]);
+                    GetSite(tokenStrings[5]);
+                }
+            }
+        }
+        else if (tokens[0] == "site" && numTokens == 4 && tokens[2] == "rank") {
+            SiteState& site = GetSite(tokenStrings[1]);
+            site.hasRank = true;
+            site.rank = tokens[3].ToDouble();
+        }
+        else if (tokens[0] == "site" && numTokens == 5 && tokens[2] == "longlat") {
+            SiteState& site = GetSite(tokenStrings[1]);
+            site.hasLongLat = true;
+            site.longitude = tokens[3].ToDouble();
+            site.latitude = tokens[4].ToDouble();
+        }
+        else if (tokens[0] == "workflow" && numTokens == 6) {
+            WorkflowState& workflow = GetWorkflow(tokenStrings[1]);
+            workflow.hasName = true;
+            workflow.username = tokenStrings[3];
+            workflow.name = tokenStrings[5];
+        }
+        else if (tokens[0] == "network_bandwidth" && numTokens == 6) {
+            SetBandwidth(tokenStrings[2], tokenStrings[4], tokens[5].ToDouble());
+        }
+    }
+}
+
+
+void ReplayState::ParseBinary(const char* data, size_t size, const std::vector<std::string>& strings) {
+    size_t position = 0;
+
+    // Follows EventParser::ParseBinary, but only keeps the results
+    while (position < size) {
+        size_t recordSize = BinaryEvent::RecordSize(data + position, size - position);
+        if (recordSize == 0) break;
+
+        const char* record = data + position + 1;
+        unsigned char opcode = (unsigned char)data[position];
+
+        position += recordSize;
+
+        if (opcode == BinaryEvent::OpEndOfFile) {
+            Reset();
+            continue;
+        }
+        else if (opcode == BinaryEvent::OpString || opcode == BinaryEvent::OpTimestamp) {
+            continue;
+        }
+
+        // Look up the strings in the record, skipping records with unknown strings
+        int numStrings = opcode == BinaryEvent::OpJobState || opcode == BinaryEvent::OpJobDataSource ||
+                         opcode == BinaryEvent::OpWorkflow ? 3 :
+                         opcode == BinaryEvent::OpSiteRank || opcode == BinaryEvent::OpSiteLongLat ? 1 : 2;
+
+        const std::string* s[3] = { NULL, NULL, NULL };
+        bool valid = true;
+        for (int i = 0; i < numStrings; i++) {
+            unsigned int id = BinaryEvent::ReadUInt(record + i * 4);
+
+            if (id < strings.size()) s[i] = &strings[id];
+            else if (!(opcode == BinaryEvent::OpJobState && i == 2 && id == BinaryEvent::NoString)) valid = false;
+        }
+        if (!valid) continue;
+
+        switch (opcode) {
+            case BinaryEvent::OpJobState: {
+                JobState& job = GetJob(*s[0]);
+                const std::string& state = *s[1];
+
+                if (state != "MATCHING" && state != "SUBMITTING" && state != "QUEUED" &&
+                    state != "RUNNING" && state != "DONE" && state != "FAILED") break;
+
+                job.state = state;
+
+                if (s[2]) job.science = *s[2];
+                break;
+            }
+
+            case BinaryEvent::OpJobToSite:
+                GetSite(*s[1]);
+                GetJob(*s[0]).site = *s[1];
+                break;
+
+            case BinaryEvent::OpJobWorkflow:
+                GetWorkflow(*s[1]);
+                GetJob(*s[0]).workflow = *s[1];
+                break;
+
+            case BinaryEvent::OpJobName:
+                GetJob(*s[0]).name = *s[1];
+                break;
+
+            case BinaryEvent::OpJobDataSource:
+                GetJob(*s[0]);
+
+                if (*s[1] != *s[2] && BinaryEvent::ReadDouble(record + 12) > 0.0) {
+                    GetSite(*s[1]);
+                    GetSite(*s[2]);
+                }
+                break;
+
+            case BinaryEvent::OpSiteRank: {
+                SiteState& site = GetSite(*s[0]);
+                site.hasRank = true;
+                site.rank = BinaryEvent::ReadDouble(record + 4);
+                break;
+            }
+
+            case BinaryEvent::OpSiteLongLat: {
+                SiteState& site = GetSite(*s[0]);
+                site.hasLongLat = true;
+                site.longitude = BinaryEvent::ReadDouble(record + 4);
+                site.latitude = BinaryEvent::ReadDouble(record + 12);
+                break;
+            }
+
+            case BinaryEvent::OpWorkflow: {
+                WorkflowState& workflow = GetWorkflow(*s[0]);
+                workflow.hasName = true;
+                workflow.username = *s[1];
+                workflow.name = *s[2];
+                break;
+            }
+
+            case BinaryEvent::OpNetworkBandwidth:
+                SetBandwidth(*s[0], *s[1], BinaryEvent::ReadDouble(record + 8));
+                break;
+        }
+    }
+}
+
+
+void ReplayState::Write(std::string& s) {
+    char line[64];
+
+    // Sites and workflows first, so jobs go to the right places
+    for (int i = 0; i < (int)sites.size(); i++) {
+        const SiteState& site = sites[i];
+
+        if (site.hasLongLat) {
+            snprintf(line, sizeof(line), " longlat %.10g %.10g\n", site.longitude, site.latitude);
+            s += "site " + site.id + line;
+        }
+        if (site.hasRank) {
+            snprintf(line, sizeof(line), " rank %.10g\n", site.rank);
+            s += "site " + site.id + line;
+        }
+    }
+
+    for (int i = 0; i < (int)workflows.size(); i++) {
+        const WorkflowState& workflow = workflows[i];
+
+        if (workflow.hasName) {
+            s += "workflow " + workflow.id + " username " + workflow.username + " name " + workflow.name + "\n";
+        }
+    }
+
+    for (int i = 0; i < (int)bandwidths.size(); i++) {
+        const BandwidthState& bandwidth = bandwidths[i];
+
+        snprintf(line, sizeof(line), " %.10g\n", bandwidth.bandwidth);
+        s += "network_bandwidth source " + bandwidth.source + " dest " + bandwidth.dest + line;
+    }
+
+    // The name is set before the state, so finished duplicates are found
+    for (int i = 0; i < (int)jobs.size(); i++) {
+        const JobState& job = jobs[i];
+
+        if (!job.workflow.empty()) s += "job " + job.id + " workflow " + job.workflow + "\n";
+        if (!job.name.empty()) s += "job " + job.id + " job_name " + job.name + "\n";
+
+        if (!job.state.empty()) {
+            s += "job " + job.id + " state " + job.state;
+            if (!job.science.empty()) s += " science " + job.science;
+            s += "\n";
+        }
+
+        if (!job.site.empty()) s += "job " + job.id + " tosite " + job.site + "\n";
+    }
+}
+
+
+void ReplayState::WriteBinary(BinaryEventWriter& writer, std::string& s) {
+    // Same order as Write
+    for (int i = 0; i < (int)sites.size(); i++) {
+        const SiteState& site = sites[i];
+
+        if (site.hasLongLat) writer.WriteSiteLongLat(site.id, site.longitude, site.latitude, s);
+        if (site.hasRank) writer.WriteSiteRank(site.id, site.rank, s);
+    }
+
+    for (int i = 0; i < (int)workflows.size(); i++) {
+        const WorkflowState& workflow = workflows[i];
+
+        if (workflow.hasName) writer.WriteWorkflow(workflow.id, workflow.username, workflow.name, s);
+    }
+
+    for (int i = 0; i < (int)bandwidths.size(); i++) {
+        const BandwidthState& bandwidth = bandwidths[i];
+
+        writer.WriteNetworkBandwidth(bandwidth.source, bandwidth.dest, bandwidth.bandwidth, s);
+    }
+
+    for (int i = 0; i < (int)jobs.size(); i++) {
+        const JobState& job = jobs[i];
+
+        if (!job.workflow.empty()) writer.WriteJobWorkflow(job.id, job.workflow, s);
+        if (!job.name.empty()) writer.WriteJobName(job.id, job.name, s);
+        if (!job.state.empty()) writer.WriteJobState(job.id, job.state, job.science.empty() ? NULL : &job.science, s);
+        if (!job.site.empty()) writer.WriteJobToSite(job.id, job.site, s);
+    }
+}
+
+
+void ReplayState::Reset() {
+    jobs.clear();
+    sites.clear();
+    workflows.clear();
+    bandwidths.clear();
+
+    jobIndex.clear();
+    siteIndex.clear();
+    workflowIndex.clear();
+    bandwidthIndex.clear();
+}
+
+
+void ReplayState::Prune() {
+    // Jobs are written in order, and a finished job removes every job with its name in its
+    // workflow that was written before it, as in Workflow::RemoveDuplicates
+    std::unordered_map<std::string, int> lastDone;
+    for (int i = 0; i < (int)jobs.size(); i++) {
+        const JobState& job = jobs[i];
+
+        if (job.state == "DONE" && !job.name.empty() && !job.workflow.empty()) {
+            lastDone[job.workflow + '\n' + job.name] = i;
+        }
+    }
+
+    if (lastDone.empty()) return;
+
+    int numKept = 0;
+    for (int i = 0; i < (int)jobs.size(); i++) {
+        JobState& job = jobs[i];
+
+        if (!job.name.empty() && !job.workflow.empty()) {
+            std::unordered_map<std::string, int>::iterator it = lastDone.find(job.workflow + '\n' + job.name);
+
+            if (it != lastDone.end() && it->second > i) {
+                jobIndex.erase(job.id);
+                continue;
+            }
+        }
+
+        if (numKept != i) {
+            std::swap(jobs[numKept], job);
+            jobIndex[jobs[numKept].id] = numKept;
+        }
+
+        numKept++;
+    }
+
+    jobs.resize(numKept);
+}
+
+
+void ReplayState::Swap(ReplayState& other) {
+    jobs.swap(other.jobs);
+    sites.swap(other.sites);
+    workflows.swap(other.workflows);
+    bandwidths.swap(other.bandwidths);
+
+    jobIndex.swap(other.jobIndex);
+    siteIndex.swap(other.siteIndex);
+    workflowIndex.swap(other.workflowIndex);
+    bandwidthIndex.swap(other.bandwidthIndex);
+}
+
+
+ReplayState::JobState& ReplayState::GetJob(const std::string& jobID) {
+    std::unordered_map<std::string, int>::iterator it = jobIndex.find(jobID);
+    if (it != jobIndex.end()) return jobs[it->second];
+
+    jobIndex[jobID] = (int)jobs.size();
+
+    JobState job;
+    job.id = jobID;
+    jobs.push_back(job);
+
+    return jobs.back();
+}
+
+
+ReplayState::SiteState& ReplayState::GetSite(const std::string& siteID) {
+    std::unordered_map<std::string, int>::iterator it = siteIndex.find(siteID);
+    if (it != siteIndex.end()) return sites[it->second];
+
+    siteIndex[siteID] = (int)sites.size();
+
+    SiteState site;
+    site.id = siteID;
+    site.hasLongLat = false;
+    site.longitude = 0.0;
+    site.latitude = 0.0;
+    site.hasRank = false;
+    site.rank = 0.0;
+    sites.push_back(site);
+
+    return sites.back();
+}
+
+
+ReplayState::WorkflowState& ReplayState::GetWorkflow(const std::string& workflowID) {
+    std::unordered_map<std::string, int>::iterator it = workflowIndex.find(workflowID);
+    if (it != workflowIndex.end()) return workflows[it->second];
+
+    workflowIndex[workflowID] = (int)workflows.size();
+
+    WorkflowState workflow;
+    workflow.id = workflowID;
+    workflow.hasName = false;
+    workflows.push_back(workflow);
+
+    return workflows.back();
+}
+
+
+void ReplayState::SetBandwidth(const std::string& sourceID, const std::string& destID, double bandwidth) {
+    // Ignore if sourceID and destID are the same or bandwidth <= 0.0
+    if (sourceID == destID || bandwidth <= 0.0) return;
+
+    GetSite(sourceID);
+    GetSite(destID);
+
+    // Connections don't have a direction, so key on the sorted pair, as in
+    // NetworkConnectionList.  The first direction seen is kept for writing.
+    std::string key = sourceID < destID ? sourceID + '\n' + destID : destID + '\n' + sourceID;
+
+    std::unordered_map<std::string, int>::iterator it = bandwidthIndex.find(key);
+    if (it != bandwidthIndex.end()) {
+        bandwidths[it->second].bandwidth = bandwidth;
+        return;
+    }
+
+    bandwidthIndex[key] = (int)bandwidths.size();
+
+    BandwidthState state;
+    state.source = sourceID;
+    state.dest = destID;
+    state.bandwidth = bandwidth;
+    bandwidths.push_back(state);
+}
\ No newline at end of file
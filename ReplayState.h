@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        ReplayState.h
+//
+// Author:      David Borland
+//
+// Description: Interface of ReplayState class for MatchMaker.  Keeps the latest state of each
+//              job, site, workflow, and network connection in a replayed data file, without
+//              any graphics, so it can be copied as a snapshot and written out as events that
+//              recreate the model.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef REPLAYSTATE_H
+#define REPLAYSTATE_H
+
+
+#include "BinaryEvent.h"
+#include "Tokenizer.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+class ReplayState {
+public:
+    ReplayState();
+    ~ReplayState();
+
+    // Apply events.  An "EOF" line or record resets the state.
+    void ParseLines(const char* data, int length);
+    void ParseBinary(const char* data, size_t size, const std::vector<std::string>& strings);
+
+    // Write events that recreate the state, in the order things were first seen
+    void Write(std::string& s);
+    void WriteBinary(BinaryEventWriter& writer, std::string& s);
+
+    void Reset();
+
+    // Drop jobs that a finished job with the same name in the same workflow would remove
+    // when the written state is parsed again, so they don't take up room in snapshots
+    void Prune();
+
+    void Swap(ReplayState& other);
+
+private:
+    struct JobState {
+        std::string id;
+        std::string state;
+        std::string science;
+        std::string site;
+        std::string workflow;
+        std::string name;
+    };
+
+    struct SiteState {
+        std::string id;
+        bool hasLongLat;
+        double longitude;
+        double latitude;
+        bool hasRank;
+        double rank;
+    };
+
+    struct WorkflowState {
+        std::string id;
+        bool hasName;
+        std::string username;
+        std::string name;
+    };
+
+    struct BandwidthState {
+        std::string source;
+        std::string dest;
+        double bandwidth;
+    };
+
+    std::vector<JobState> jobs;
+    std::vector<SiteState> sites;
+    std::vector<WorkflowState> workflows;
+    std::vector<BandwidthState> bandwidths;
+
+    // Index of each by ID.  Bandwidths are indexed by the sorted pair of sites.
+    std::unordered_map<std::string, int> jobIndex;
+    std::unordered_map<std::string, int> siteIndex;
+    std::unordered_map<std::string, int> workflowIndex;
+    std::unordered_map<std::string, int> bandwidthIndex;
+
+    // Scratch strings for tokens
+    std::string tokenStrings[Tokenizer::MaxTokens];
+
+    // Get or create
+    JobState& GetJob(const std::string& jobID);
+    SiteState& GetSite(const std::string& siteID);
+    WorkflowState& GetWorkflow(const std::string& workflowID);
+
+    void SetBandwidth(const std::string& sourceID, const std::string& destID, double bandwidth);
+};
+
+
+#endif
\ No newline at end of file
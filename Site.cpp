@@ -19,6 +19,7 @@
 
 #include <vtkTextActor3D.h>
 
+#include "GeometryCache.h"
 #include "Projector.h"
 
 #include <wx/log.h>
@@ -27,10 +28,10 @@
 Site::Site(const std::string& siteID, double radius, vtkRenderer* ren, vtkColorTransferFunction* lookUpTable,
            double jobSpacingDistance, double siteSpacingDistance, int maxSiteStackSize, bool showSiteSpindle, 
            double* mapXYExtents, const Vec2& unknownPosition, const Vec2& offTheMapPosition, 
-           double labelHeight, bool labelFaceCamera, bool darkBackground) 
+           LabelLayer* labelLayer, bool labelFaceCamera, bool darkBackground, GlyphSet* barGlyphs) 
 : Object(siteID, radius, ren), lut(lookUpTable), 
          jobSpacing(jobSpacingDistance), siteSpacing(siteSpacingDistance), maxStackSize(maxSiteStackSize), showSpindle(showSiteSpindle), 
-         mapExtents(mapXYExtents), unknownPos(unknownPosition), offTheMapPos(offTheMapPosition) {
+         mapExtents(mapXYExtents), unknownPos(unknownPosition), offTheMapPos(offTheMapPosition), bars(barGlyphs) {
     // Defaults
     innerRadius = radius;
     outerRadius = radius * 1.5;
@@ -40,33 +41,29 @@ Site::Site(const std::string& siteID, double radius, vtkRenderer* ren, vtkColorT
     siteZ = 0.1;
     anchorOffset = 0.05;
     jobOffset = 0.05;
+    layoutChanged = true;
+    showBars = false;
+    barsModified = true;
+    retiredCounts.resize(Job::NumStates, 0);
+    numRetired = 0;
 
 
     // Create the first stack
-    stacks.push_back(new Stack(0.0, outerRadius, spindleRadius, resolution, showSpindle, renderer));
+    stacks.push_back(new Stack(0.0, outerRadius, spindleRadius, resolution, showSpindle, renderer, bars));
 
 
     // Create an anchor point
-    anchor = vtkDiskSource::New();
-    anchor->SetRadialResolution(1);
-    anchor->SetCircumferentialResolution(resolution);
-    anchor->SetInnerRadius(0.0);
-    anchor->SetOuterRadius(anchorRadius);
-    vtkPolyDataMapper* anchorMapper = vtkPolyDataMapper::New();
-    anchorMapper->SetInputConnection(anchor->GetOutputPort());
     anchorActor = vtkActor::New();
-    anchorActor->SetMapper(anchorMapper);
+    anchorActor->SetMapper(GeometryCache::GetMapper(GeometryCache::Disk, resolution));
+    anchorActor->SetScale(anchorRadius, anchorRadius, 1.0);
     anchorActor->GetProperty()->SetAmbient(1.0);
     anchorActor->GetProperty()->SetDiffuse(0.0);
     anchorActor->GetProperty()->SetSpecular(0.0);
 
 
     // Create an anchor line
-    anchorLine = vtkLineSource::New();
-    vtkPolyDataMapper* anchorLineMapper = vtkPolyDataMapper::New();
-    anchorLineMapper->SetInputConnection(anchorLine->GetOutputPort());
     anchorLineActor = vtkActor::New();
-    anchorLineActor->SetMapper(anchorLineMapper); 
+    anchorLineActor->SetMapper(GeometryCache::GetMapper(GeometryCache::Line, 1)); 
     anchorLineActor->GetProperty()->SetLineWidth(2.0);
 
 
@@ -78,23 +75,12 @@ Site::Site(const std::string& siteID, double radius, vtkRenderer* ren, vtkColorT
 
     // Create text label for the site
     if (labelFaceCamera) {
-        text = vtkCaptionActor2D::New();
-        text->SetCaption(id.c_str());
-        text->GetPositionCoordinate()->SetCoordinateSystemToNormalizedViewport();
-        text->GetPositionCoordinate()->SetValue(-0.5, -labelHeight);
-        text->SetWidth(1.0);
-        text->SetHeight(labelHeight);
-        text->BorderOff();
-        text->ThreeDimensionalLeaderOff();
-        text->GetCaptionTextProperty()->SetJustificationToCentered();
-        text->GetCaptionTextProperty()->BoldOff();
-        text->GetCaptionTextProperty()->ShadowOff();
-        text->GetCaptionTextProperty()->ItalicOff();
-        text->GetProperty()->SetLineStipplePattern(0x0000);
-        if (darkBackground) text->GetProperty()->SetColor(1.0, 1.0, 1.0);
-        else text->GetProperty()->SetColor(0.0, 0.0, 0.0);
-
-        renderer->AddViewProp(text);
+        labels = labelLayer;
+        labelRow = labels->AddRow();
+        labels->SetText(labelRow, id);
+        if (darkBackground) labels->SetColor(labelRow, 1.0, 1.0, 1.0);
+        else labels->SetColor(labelRow, 0.0, 0.0, 0.0);
+        labels->SetVisible(labelRow, true);
 
         text3D = NULL;
     }
@@ -110,19 +96,15 @@ Site::Site(const std::string& siteID, double radius, vtkRenderer* ren, vtkColorT
 
         renderer->AddViewProp(text3D);
 
-        text = NULL;
+        labels = NULL;
+        labelRow = -1;
     }
 
     // Default position
     anchorActor->SetPosition(unknownPos.X(), unknownPos.Y(), siteZ - anchorOffset);
-    anchorLine->SetPoint1(unknownPos.X(), unknownPos.Y(), siteZ - anchorOffset);
+    anchorLineStart.Set(unknownPos.X(), unknownPos.Y(), siteZ - anchorOffset);
     SetPosition(Vec3(unknownPos.X(), unknownPos.Y(), siteZ));
     location.Set(unknownPos.X(), unknownPos.Y(), siteZ);
-
-
-    // Don't need these references any more
-    anchorLineMapper->Delete();
-    anchorMapper->Delete();
 }
 
 
@@ -133,15 +115,12 @@ Site::~Site() {
     // Remove actors
     renderer->RemoveViewProp(anchorActor);
     renderer->RemoveViewProp(anchorLineActor);
-    if (text) renderer->RemoveViewProp(text);
+    if (labelRow >= 0) labels->RemoveRow(labelRow);
     if (text3D) renderer->RemoveViewProp(text3D);
 
     // Clean up
-    anchor->Delete();
     anchorActor->Delete();
-    anchorLine->Delete();
     anchorLineActor->Delete();
-    if (text) text->Delete();
     if (text3D) text3D->Delete();
 }
 
@@ -168,7 +147,7 @@ void Site::SetLongLat(double longitude, double latitude) {
 
     // This is the new anchor point
     anchorActor->SetPosition(x, y, siteZ + anchorOffset);
-    anchorLine->SetPoint1(x, y, siteZ + anchorOffset);
+    anchorLineStart.Set(x, y, siteZ + anchorOffset);
 
     // Set this as the location
     Vec3 pos(x, y, siteZ);
@@ -177,6 +156,8 @@ void Site::SetLongLat(double longitude, double latitude) {
 
     // Set this as the position
     SetPosition(pos);
+
+    layoutChanged = true;
 }
 
 
@@ -184,7 +165,7 @@ void Site::SetPosition(const Vec3& pos) {
     position = pos;
 
     // Set the attachment point for the text
-    if (text) text->SetAttachmentPoint(position.X(), position.Y() - outerRadius, position.Z());
+    if (labelRow >= 0) labels->SetPosition(labelRow, position.X(), position.Y() - outerRadius, position.Z());
     if (text3D) text3D->SetPosition(position.X() - outerRadius * 2, position.Y() - outerRadius * 2, position.Z() + anchorOffset);
 
     
@@ -207,7 +188,8 @@ void Site::SetPosition(const Vec3& pos) {
     diff.Normalize();
 
     double offset = innerRadius + (outerRadius - innerRadius) / 2.0;
-    anchorLine->SetPoint2(stackPos.X() + diff.X() * offset, stackPos.Y() + diff.Y() * offset, position.Z());
+    GeometryCache::SetLine(anchorLineActor, anchorLineStart, 
+                           Vec3(stackPos.X() + diff.X() * offset, stackPos.Y() + diff.Y() * offset, position.Z()));
 
 
     // Show the anchor actors if necessary
@@ -246,9 +228,11 @@ void Site::SetRadius(double radius) {
     for (int i = 0; i < (int)stacks.size(); i++) {
         stacks[i]->SetRadii(0.0, outerRadius, spindleRadius);
     }
-    anchor->SetOuterRadius(anchorRadius);
+    anchorActor->SetScale(anchorRadius, anchorRadius, 1.0);
     
     SetPosition(position);
+
+    layoutChanged = true;
 }
 
 
@@ -256,6 +240,7 @@ void Site::SetJobSpacing(double spacing) {
     jobSpacing = spacing;
 
     StackJobs();
+    barsModified = true;
 }   
 
 
@@ -271,10 +256,10 @@ void Site::SetMaxStackSize(int size) {
 }
 
 
-void Site::SetRank(std::string rank) {
+void Site::SetRank(double rank) {
     // Update the color
     double rgb[3];
-    lut->GetColor(atof(rank.c_str()), rgb);
+    lut->GetColor(rank, rgb);
     SetColor(rgb[0], rgb[1], rgb[2]);
 }
 
@@ -311,22 +296,72 @@ void Site::AttachJob(Job* job) {
     }
 
     job->SetSite(this);
+
+    // Already here, travelling from this site
+    std::unordered_map<std::string, int>::iterator it = jobSlots.find(job->GetID());
+    if (it != jobSlots.end()) {
+        PlaceJob(it->second);
+        return;
+    }
+
+    // Give the job the next slot
+    int slot = (int)jobs.size();
     jobs.push_back(job);
+    jobSlots[job->GetID()] = slot;
 
-    if ((int)jobs.size() > mostNumJobs) mostNumJobs = (int)jobs.size();
+    bool mostChanged = false;
+    if ((int)jobs.size() > mostNumJobs) {
+        mostNumJobs = (int)jobs.size();
+        mostChanged = true;
+    }
 
-    Update();
+    if (GetNumStacksNeeded() != (int)stacks.size()) {
+        // Adding a stack moves the others
+        Update();
+    }
+    else {
+        PlaceJob(slot);
+
+        if (mostChanged) UpdateLastSpindle();
+    }
 }
 
-void Site::RemoveJob(std::string jobId) {
-    for (int i = 0; i < (int)jobs.size(); i++) {
-        if (jobs[i]->GetID() == jobId) {
-            jobs.erase(jobs.begin() + i);
-            break;
-        }
+void Site::RemoveJob(const std::string& jobId) {
+    std::unordered_map<std::string, int>::iterator it = jobSlots.find(jobId);
+    if (it == jobSlots.end()) return;
+
+    int slot = it->second;
+    jobSlots.erase(it);
+
+    // Fill the hole with the last job
+    int last = (int)jobs.size() - 1;
+    if (slot != last) {
+        jobs[slot] = jobs[last];
+        jobSlots[jobs[slot]->GetID()] = slot;
+
+        PlaceJob(slot);
     }
 
-    Update();
+    RemoveLastSlot();
+
+    if (GetNumStacksNeeded() != (int)stacks.size()) Update();
+}
+
+
+void Site::RetireJob(Job* job) {
+    retiredCounts[job->GetState()]++;
+    numRetired++;
+
+    SetCaption();
+}
+
+void Site::UnretireJob(int state) {
+    if (retiredCounts[state] == 0) return;
+
+    retiredCounts[state]--;
+    numRetired--;
+
+    SetCaption();
 }
 
 
@@ -357,68 +392,184 @@ void Site::ResetSpindle() {
 }
 
 void Site::Update() {
+    int numStacks = (int)stacks.size();
+
+    // Slots may move to other stacks, so count them again as they are placed
+    slotStates.clear();
+    stateCounts.clear();
+    barsModified = true;
+
     ArrangeStacks();
     StackJobs();
+
+    if ((int)stacks.size() != numStacks) layoutChanged = true;
 }
 
 
-void Site::StackJobs() {
-    int stackNum = 0;
-    Vec3 pos = stacks[stackNum]->GetPosition();
-    double z = pos.Z() + jobOffset;
+void Site::ShowBars(bool show) {
+    showBars = show;
 
-    double jobHeight = 0.0;
-    for (int i = 0; i < (int)jobs.size(); i++) {
-        jobHeight = jobs[i]->GetHeight();
-        z += jobHeight * 0.5;
+    for (int i = 0; i < (int)stacks.size(); i++) {
+        stacks[i]->ShowBar(showBars);
+    }
 
-        if (jobs[i]->GetSite()->GetID() == id) {
-            // This site owns this job
-            jobs[i]->SetPosition(Vec3(pos.X(), pos.Y(), z));
-        }
-        else {
-            // This job is travelling from this site
-            jobs[i]->SetOldPosition(Vec3(pos.X(), pos.Y(), z));
-        }
+    barsModified = true;
+}
+
+
+void Site::JobChanged(const std::string& jobId) {
+    std::unordered_map<std::string, int>::iterator it = jobSlots.find(jobId);
+    if (it != jobSlots.end()) CountBarSlot(it->second);
+}
+
+
+bool Site::UpdateBars() {
+    if (!showBars || !barsModified) return false;
+
+    barsModified = false;
+
+    int numStacks = (int)stacks.size();
+    stateCounts.resize(numStacks * Job::NumStates, 0);
+
+    // All jobs are the same size
+    double jobHeight = jobs.empty() ? 0.0 : jobs[0]->GetHeight();
+    double jobRadius = jobs.empty() ? 0.0 : jobs[0]->GetRadius();
+
+    for (int i = 0; i < numStacks; i++) {
+        const int* counts = &stateCounts[i * Job::NumStates];
+
+        int numJobs = 0;
+        for (int j = 0; j < Job::NumStates; j++) numJobs += counts[j];
 
-        z += jobHeight * 0.5 + jobSpacing;
+        // Span the same height as the jobs, split in proportion to the states
+        double height = numJobs > 0 ? numJobs * (jobHeight + jobSpacing) - jobSpacing : 0.0;
+        double bottom = GetStackBase(i);
 
-        if (((i + 1) % maxStackSize) == 0) {
-            stackNum++;
-            pos = stacks[stackNum]->GetPosition();
-            z = pos.Z() + 0.2;
+        for (int j = 0; j < Job::NumStates; j++) {
+            double segmentHeight = numJobs > 0 ? height * counts[j] / numJobs : 0.0;
+
+            stacks[i]->SetBarSegment(j, bottom, segmentHeight, jobRadius, Job::GetStateColor((Job::StateType)j));
+
+            bottom += segmentHeight;
         }
     }
 
+    return true;
+}
+
+
+void Site::CountBarSlot(int slot) {
+    int state = jobs[slot]->GetSite() == this ? jobs[slot]->GetState() : -1;
+
+    if ((int)slotStates.size() <= slot) slotStates.resize(slot + 1, -1);
+    if (slotStates[slot] == state) return;
+
+    UncountBarSlot(slot);
+
+    if (state >= 0) {
+        int index = (slot / maxStackSize) * Job::NumStates + state;
+        if ((int)stateCounts.size() <= index) stateCounts.resize(index + 1, 0);
+
+        stateCounts[index]++;
+    }
+
+    slotStates[slot] = state;
+    barsModified = true;
+}
+
+void Site::UncountBarSlot(int slot) {
+    if (slot < 0 || slot >= (int)slotStates.size() || slotStates[slot] < 0) return;
+
+    stateCounts[(slot / maxStackSize) * Job::NumStates + slotStates[slot]]--;
+
+    slotStates[slot] = -1;
+    barsModified = true;
+}
+
+
+void Site::StackJobs() {
+    for (int i = 0; i < (int)jobs.size(); i++) {
+        PlaceJob(i);
+    }
+
+    UpdateSpindles();
+}
+
+
+void Site::PlaceJob(int slot) {
+    int stackNum = slot / maxStackSize;
+    Vec3 pos = stacks[stackNum]->GetPosition();
+
+    // All jobs are the same height
+    double jobHeight = jobs[slot]->GetHeight();
+    double z = GetStackBase(stackNum) + (slot % maxStackSize) * (jobHeight + jobSpacing) + jobHeight * 0.5;
+
+    CountBarSlot(slot);
+
+    if (jobs[slot]->GetSite() == this) {
+        // This site owns this job
+        jobs[slot]->SetPosition(Vec3(pos.X(), pos.Y(), z));
+    }
+    else {
+        // This job is travelling from this site
+        jobs[slot]->SetOldPosition(Vec3(pos.X(), pos.Y(), z));
+    }
+}
+
+
+void Site::RemoveLastSlot() {
+    UncountBarSlot((int)jobs.size() - 1);
+
+    jobs.pop_back();
+}
+
+
+void Site::UpdateSpindles() {
+    double jobHeight = jobs.empty() ? 0.0 : jobs.back()->GetHeight();
+
     // Set to maximum height
     double spindleHeight = maxStackSize * jobHeight + (maxStackSize - 1) * jobSpacing - jobHeight * 0.5;
     for (int i = 0; i < (int)stacks.size() - 1; i++) {
         stacks[i]->SetSpindleHeight(spindleHeight);
     }
 
+    UpdateLastSpindle();
+}
+
+void Site::UpdateLastSpindle() {
+    double jobHeight = jobs.empty() ? 0.0 : jobs.back()->GetHeight();
+
     // Set to height based on number of jobs at last stack
     int remainder = (mostNumJobs - maxStackSize * ((int)stacks.size() - 1));
-    spindleHeight = remainder * jobHeight + (remainder - 1) * jobSpacing - jobHeight * 0.5;
+    double spindleHeight = remainder * jobHeight + (remainder - 1) * jobSpacing - jobHeight * 0.5;
     spindleHeight = spindleHeight < 0.1 ? 0.1 : spindleHeight;
     stacks.back()->SetSpindleHeight(spindleHeight);
 }
 
 
-void Site::ArrangeStacks() {
-    int numStacks;
-
-    if (showSpindle) {
-        numStacks = mostNumJobs / maxStackSize + 1;
-    }
-    else {
-        numStacks = (int)jobs.size() / maxStackSize + 1;
+void Site::SetCaption() {
+    // Retired jobs are no longer stacked, so show how many there were
+    std::string caption = id;
+    if (numRetired > 0) {
+        char buffer[32];
+        sprintf_s(buffer, sizeof(buffer), " (+%d)", numRetired);
+        caption += buffer;
     }
 
+    if (labelRow >= 0) labels->SetText(labelRow, caption);
+    if (text3D) text3D->SetInput(caption.c_str());
+}
+
+
+void Site::ArrangeStacks() {
+    int numStacks = GetNumStacksNeeded();
+
     if (numStacks > (int)stacks.size()) {
         int numToAdd = numStacks - (int)stacks.size();
         for (int i = 0; i < numToAdd; i++) {
-            stacks.push_back(new Stack(0.0, outerRadius, spindleRadius, resolution, showSpindle, renderer));
+            stacks.push_back(new Stack(0.0, outerRadius, spindleRadius, resolution, showSpindle, renderer, bars));
             stacks.back()->SetColor(color[0], color[1], color[2]);
+            stacks.back()->ShowBar(showBars);
         }
     }
     else if (numStacks < (int)stacks.size()) {
@@ -441,6 +592,21 @@ void Site::ArrangeStacks() {
 }
 
 
+double Site::GetStackBase(int stackNum) {
+    return stacks[stackNum]->GetPosition().Z() + (stackNum == 0 ? jobOffset : 0.2);
+}
+
+
+int Site::GetNumStacksNeeded() {
+    if (showSpindle) {
+        return mostNumJobs / maxStackSize + 1;
+    }
+    else {
+        return (int)jobs.size() / maxStackSize + 1;
+    }
+}
+
+
 void Site::GetClosestStackCenter(const Vec2& pos, Vec2& stackPos) {
     double closestDist;
     for (int i = 0; i < (int)stacks.size(); i++) {
@@ -473,6 +639,15 @@ Vec3 Site::GetStackPosition(int i) {
 }
 
 
+bool Site::GetLayoutChanged() {
+    return layoutChanged;
+}
+
+void Site::ClearLayoutChanged() {
+    layoutChanged = false;
+}
+
+
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -480,10 +655,10 @@ Vec3 Site::GetStackPosition(int i) {
 SpecialSite::SpecialSite(const std::string& siteName, double radius, vtkRenderer* ren, vtkColorTransferFunction* lookUpTable,
                          double jobSpacingDistance, double siteSpacingDistance, int maxSiteStackSize, bool showSiteSpindle, 
                          double* mapXYExtents, const Vec2& unknownPosition, const Vec2& offTheMapPosition, 
-                         double labelHeight, bool labelFaceCamera, bool darkBackground) 
+                         LabelLayer* labelLayer, bool labelFaceCamera, bool darkBackground, GlyphSet* barGlyphs) 
 : Site(siteName, radius, ren, lookUpTable, 
        jobSpacingDistance, siteSpacingDistance, maxSiteStackSize, showSiteSpindle, 
-       mapXYExtents, unknownPosition, offTheMapPosition, labelHeight, labelFaceCamera, darkBackground) {
+       mapXYExtents, unknownPosition, offTheMapPosition, labelLayer, labelFaceCamera, darkBackground, barGlyphs) {
     // Default gap value
     gap = 20.0;
     border = 5.0;
@@ -569,26 +744,20 @@ void SpecialSite::UpdateBorder() {
 
 void SpecialSite::UpdatePosition() {
     anchorActor->SetPosition(mapExtents[0] - gap - (border + outerRadius), mapExtents[1] + border + outerRadius, siteZ + anchorOffset);
-    anchorLine->SetPoint1(anchorActor->GetPosition());
+    anchorLineStart.Set(anchorActor->GetPosition()[0], anchorActor->GetPosition()[1], anchorActor->GetPosition()[2]);
     SetPosition(Vec3(anchorActor->GetPosition()[0], anchorActor->GetPosition()[1], siteZ));
 }
 
 
 void SpecialSite::ArrangeStacks() {
-    int numStacks;
-
-    if (showSpindle) {
-        numStacks = mostNumJobs / maxStackSize + 1;
-    }
-    else {
-        numStacks = (int)jobs.size() / maxStackSize + 1;
-    }
+    int numStacks = GetNumStacksNeeded();
 
     if (numStacks > (int)stacks.size()) {
         int numToAdd = numStacks - (int)stacks.size();
         for (int i = 0; i < numToAdd; i++) {
-            stacks.push_back(new Stack(innerRadius, outerRadius, spindleRadius, resolution, showSpindle, renderer));
+            stacks.push_back(new Stack(innerRadius, outerRadius, spindleRadius, resolution, showSpindle, renderer, bars));
             stacks.back()->SetColor(color[0], color[1], color[2]);
+            stacks.back()->ShowBar(showBars);
         }
     }
     else if (numStacks < (int)stacks.size()) {
@@ -636,9 +805,9 @@ void SpecialSite::CreatePlane(vtkPlaneSource*& plane, vtkActor*& actor) {
 DoneSite::DoneSite(const std::string& siteName, double radius, vtkRenderer* ren, vtkColorTransferFunction* lookUpTable,
                    double jobSpacingDistance, double siteSpacingDistance, int maxSiteStackSize, bool showSiteSpindle, 
                    double* mapXYExtents, const Vec2& unknownPosition, const Vec2& offTheMapPosition, 
-                   double labelHeight, bool labelFaceCamera, bool darkBackground) 
+                   LabelLayer* labelLayer, bool labelFaceCamera, bool darkBackground, GlyphSet* barGlyphs) 
 : SpecialSite(siteName, radius, ren, lookUpTable, jobSpacingDistance, siteSpacingDistance, maxSiteStackSize, showSiteSpindle, 
-              mapXYExtents, unknownPosition, offTheMapPosition, labelHeight, labelFaceCamera, darkBackground) {
+              mapXYExtents, unknownPosition, offTheMapPosition, labelLayer, labelFaceCamera, darkBackground, barGlyphs) {
     // Initialize variables
     numJobs = numDone = 0;
 
@@ -658,6 +827,14 @@ void DoneSite::SetNumJobs(int num) {
 }
 
 
+void DoneSite::JobChanged(const std::string& jobId) {
+    Site::JobChanged(jobId);
+
+    std::unordered_map<std::string, int>::iterator it = jobSlots.find(jobId);
+    if (it != jobSlots.end() && CountSlot(it->second)) SetCaption();
+}
+
+
 void DoneSite::UpdateStrip() {
     strip->SetOrigin(mapExtents[2] + gap, mapExtents[1], 0.0);
     strip->SetPoint1(mapExtents[2] + gap + 2.0 * (border + outerRadius), mapExtents[1], 0.0);
@@ -668,63 +845,70 @@ void DoneSite::UpdateStrip() {
 
 void DoneSite::UpdatePosition() {
     anchorActor->SetPosition(mapExtents[2] + gap + border + outerRadius, mapExtents[1] + border + outerRadius, siteZ + anchorOffset);
-    anchorLine->SetPoint1(anchorActor->GetPosition());
+    anchorLineStart.Set(anchorActor->GetPosition()[0], anchorActor->GetPosition()[1], anchorActor->GetPosition()[2]);
     SetPosition(Vec3(anchorActor->GetPosition()[0], anchorActor->GetPosition()[1], siteZ));
 }
 
 
 void DoneSite::StackJobs() {
-    int stackNum = 0;
-    Vec3 pos = stacks[stackNum]->GetPosition();
-    double z = pos.Z() + jobOffset;
-
+    // Count again from scratch
+    slotDone.clear();
     numDone = 0;
-    double jobHeight = 0.0;
+
     for (int i = 0; i < (int)jobs.size(); i++) {
-        jobHeight = jobs[i]->GetHeight();
-        z += jobHeight * 0.5;
+        Site::PlaceJob(i);
+        CountSlot(i);
+    }
 
-        if (jobs[i]->GetSite()->GetID() == id) {
-            // This site owns this job
-            jobs[i]->SetPosition(Vec3(pos.X(), pos.Y(), z));
+    UpdateSpindles();
 
-            if (jobs[i]->IsDone()) {
-                numDone++;
-            }
-        }
-        else {
-            // This job is travelling from this site
-            jobs[i]->SetOldPosition(Vec3(pos.X(), pos.Y(), z));
-        }
+    SetCaption();
+}
 
-        z += jobHeight * 0.5 + jobSpacing;
 
-        if (((i + 1) % maxStackSize) == 0) {
-            stackNum++;
-            pos = stacks[stackNum]->GetPosition();
-            z = pos.Z() + 0.2;
-        }
-    }
+void DoneSite::PlaceJob(int slot) {
+    Site::PlaceJob(slot);
 
-    // Set to maximum height
-    double spindleHeight = maxStackSize * jobHeight + (maxStackSize - 1) * jobSpacing - jobHeight * 0.5;
-    for (int i = 0; i < (int)stacks.size() - 1; i++) {
-        stacks[i]->SetSpindleHeight(spindleHeight);
+    if (CountSlot(slot)) SetCaption();
+}
+
+
+bool DoneSite::CountSlot(int slot) {
+    bool done = jobs[slot]->GetSite() == this && jobs[slot]->IsDone();
+
+    if (slot >= (int)slotDone.size()) {
+        slotDone.resize(slot + 1, false);
     }
 
-    // Set to height based on number of jobs at last stack
-    int remainder = (mostNumJobs - maxStackSize * ((int)stacks.size() - 1));
-    spindleHeight = remainder * jobHeight + (remainder - 1) * jobSpacing - jobHeight * 0.5;
-    spindleHeight = spindleHeight < 0.1 ? 0.1 : spindleHeight;
-    stacks.back()->SetSpindleHeight(spindleHeight);
+    if (done == slotDone[slot]) return false;
 
-    SetCaption();
+    slotDone[slot] = done;
+    numDone += done ? 1 : -1;
+
+    return true;
+}
+
+
+void DoneSite::RemoveLastSlot() {
+    int last = (int)jobs.size() - 1;
+
+    if (last < (int)slotDone.size()) {
+        if (slotDone[last]) {
+            numDone--;
+
+            SetCaption();
+        }
+
+        slotDone.resize(last);
+    }
+
+    Site::RemoveLastSlot();
 }
 
 
 void DoneSite::SetCaption() {
     char buffer[32];
-    sprintf_s(buffer, sizeof(buffer), ": %d / %d", numDone, numJobs);
-    if (text) text->SetCaption(std::string(id + buffer).c_str());
+    sprintf_s(buffer, sizeof(buffer), ": %d / %d", numDone + retiredCounts[Job::Done], numJobs);
+    if (labelRow >= 0) labels->SetText(labelRow, id + buffer);
     if (text3D) text3D->SetInput(std::string(id + buffer).c_str());
 }
\ No newline at end of file
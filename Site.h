@@ -17,21 +17,21 @@
 #include "Object.h"
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <vtkActor.h>
-#include <vtkCaptionActor2D.h>
 #include <vtkColorTransferFunction.h>
 #include <vtkCylinderSource.h>
-#include <vtkDiskSource.h>
-#include <vtkLineSource.h>
 #include <vtkPlaneSource.h>
 #include <vtkTextActor3D.h>
 
 #include <Vec2.h>
 #include <Vec3.h>
 
+#include "GlyphSet.h"
 #include "Job.h"
+#include "LabelLayer.h"
 #include "NetworkConnection.h"
 #include "Stack.h"
 
@@ -45,7 +45,7 @@ public:
     Site(const std::string& siteID, double radius, vtkRenderer* ren, vtkColorTransferFunction* lookUpTable,
          double jobSpacingDistance, double siteSpacingDistance, int maxSiteStackSize, bool showSiteSpindle, 
          double* mapXYExtents, const Vec2& unknownPosition, const Vec2& offTheMapPosition, 
-         double labelHeight, bool labelFaceCamera, bool darkBackground);
+         LabelLayer* labelLayer, bool labelFaceCamera, bool darkBackground, GlyphSet* barGlyphs);
     virtual ~Site();
 
     // Position and location
@@ -70,11 +70,16 @@ public:
     void SetMaxStackSize(int size);
     
     // Set the rank
-    void SetRank(std::string rank);
+    void SetRank(double rank);
 
     // Add and remove jobs
     void AttachJob(Job* job);
-    void RemoveJob(std::string jobId);
+    void RemoveJob(const std::string& jobId);
+
+    // Count a finished job that is about to be deleted to save memory, and take one back out
+    // if it turns out to be a duplicate
+    void RetireJob(Job* job);
+    void UnretireJob(int state);
 
     // Add network connections
     void AddNetworkConnection(NetworkConnection* connection);
@@ -86,16 +91,31 @@ public:
     // Update the site
     void Update();
 
+    // Draw one bar per stack, split by job state, instead of the jobs.  Call JobChanged when
+    // a job here changes state or leaves, and UpdateBars once per frame.  UpdateBars returns
+    // true if the bars changed.
+    void ShowBars(bool show);
+    virtual void JobChanged(const std::string& jobId);
+    bool UpdateBars();
+
     // Stack info
     int GetNumStacks();
     Vec3 GetStackPosition(int i);
     void GetClosestStackCenter(const Vec2& pos, Vec2& stackPos);
 
+    // Whether the location or number of stacks has changed, so the site layout needs updating
+    bool GetLayoutChanged();
+    void ClearLayoutChanged();
+
 protected:
     // The jobs at this site.  These are pointers to Jobs in the Engine's JobList.
     // They are neither created nor destroyed here.
     std::vector<Job*> jobs;
 
+    // The slot of each job in jobs, by ID.  A job keeps its slot until it is removed, when
+    // the last job moves into the hole, so only those two slots need to be placed again.
+    std::unordered_map<std::string, int> jobSlots;
+
     // The network connections at this site.  These are pointers to NetworkConnections in the Engine's NetworkConnectionList.
     // They are neither created nor destroyed here.
     std::vector<NetworkConnection*> connections;
@@ -105,13 +125,14 @@ protected:
 
     // An anchor from the current site position to the actual site position.  
     // This is necessary when site are moved to keep space between them.
-    vtkDiskSource* anchor;
+    // Both use shared unit geometry.
     vtkActor* anchorActor;
-    vtkLineSource* anchorLine;
     vtkActor* anchorLineActor;
+    Vec3 anchorLineStart;
 
-    // The site name
-    vtkCaptionActor2D* text;
+    // The site name.  Labels facing the camera are a row in the shared label layer.
+    LabelLayer* labels;
+    int labelRow;
     vtkTextActor3D* text3D;
 
     // Lookup table for the site color
@@ -155,6 +176,24 @@ protected:
     // Show spindles or not
     bool showSpindle;
 
+    // Set when the location or number of stacks changes
+    bool layoutChanged;
+
+    // Aggregate bars.  The state counted for each slot, or -1 if the job there is travelling
+    // from this site, and the number of jobs in each state for each stack.
+    GlyphSet* bars;
+    bool showBars;
+    bool barsModified;
+    std::vector<int> slotStates;
+    std::vector<int> stateCounts;
+
+    void CountBarSlot(int slot);
+    void UncountBarSlot(int slot);
+
+    // Number of retired jobs, by state, and in total
+    std::vector<int> retiredCounts;
+    int numRetired;
+
     // Map extents
     double* mapExtents;
     Vec2 unknownPos;
@@ -162,9 +201,24 @@ protected:
 
     // Arrange the stacks
     virtual void ArrangeStacks();
+    int GetNumStacksNeeded();
+
+    // Height of the bottom of a stack's first job, less half its height
+    double GetStackBase(int stackNum);
     
     // Stack the jobs
     virtual void StackJobs();
+
+    // Position the job in a slot, and remove the last slot
+    virtual void PlaceJob(int slot);
+    virtual void RemoveLastSlot();
+
+    // Spindle heights.  Only the last stack's height changes as jobs are added.
+    void UpdateSpindles();
+    void UpdateLastSpindle();
+
+    // Set the label text
+    virtual void SetCaption();
 };
 
 
@@ -176,7 +230,7 @@ public:
     SpecialSite(const std::string& siteName, double radius, vtkRenderer* ren, vtkColorTransferFunction* lookUpTable,
                 double jobSpacingDistance, double siteSpacingDistance, int maxSiteStackSize, bool showSiteSpindle, 
                 double* mapXYExtents, const Vec2& unknownPosition, const Vec2& offTheMapPosition, 
-                double labelHeight, bool labelFaceCamera, bool darkBackground);
+                LabelLayer* labelLayer, bool labelFaceCamera, bool darkBackground, GlyphSet* barGlyphs);
     virtual ~SpecialSite();
 
     virtual void SetRadius(double radius);
@@ -215,21 +269,32 @@ public:
     DoneSite(const std::string& siteName, double radius, vtkRenderer* ren, vtkColorTransferFunction* lookUpTable,
              double jobSpacingDistance, double siteSpacingDistance, int maxSiteStackSize, bool showSiteSpindle, 
              double* mapXYExtents, const Vec2& unknownPosition, const Vec2& offTheMapPosition, 
-             double labelHeight, bool labelFaceCamera, bool darkBackground);
+             LabelLayer* labelLayer, bool labelFaceCamera, bool darkBackground, GlyphSet* barGlyphs);
     virtual ~DoneSite();
 
     void SetNumJobs(int num);
 
+    // Also keeps the done count up to date
+    virtual void JobChanged(const std::string& jobId);
+
 protected:
     int numJobs;
     int numDone;
 
-    void SetCaption();
+    // Whether the job in each slot was counted as done
+    std::vector<bool> slotDone;
+
+    virtual void SetCaption();
+
+    // Count whether the job in the slot is done, returning true if numDone changed
+    bool CountSlot(int slot);
 
     virtual void UpdateStrip();
     virtual void UpdatePosition();
 
     virtual void StackJobs();
+    virtual void PlaceJob(int slot);
+    virtual void RemoveLastSlot();
 };
 
 
@@ -11,8 +11,12 @@
 
 #include "SiteList.h"
 
+#include "GeometryCache.h"
+
 #include <vtkTextProperty.h>
 
+#include <math.h>
+
 #include <wx/log.h>
 
 
@@ -27,8 +31,18 @@ SiteList::SiteList(vtkRenderer* ren, vtkRenderer* legendRen, bool useDarkBackgro
 
     showSiteRankingLegend = true;
 
-    labelHeight = 0.0;
+    repulsionCutoff = 5.0;
+
+    converged = false;
+    maxDisplacement = 0.0;
+    convergenceThreshold = 0.01;
+
     labelFaceCamera = true;
+    labels = new LabelLayer(renderer, LabelLayer::Centered);
+
+    // Unit cylinder along z, scaled per bar segment
+    bars = new GlyphSet(GeometryCache::GetOutputPort(GeometryCache::Cylinder, 16), renderer);
+    showBars = false;
 
     // Create the lookup table and scalar bar
     double colorScale = darkBackground ? 0.4 : 0.75;
@@ -74,6 +88,9 @@ SiteList::~SiteList() {
         delete sites[i];
     }
 
+    delete labels;
+    delete bars;
+
     lut->Delete();
     scalarBar->Delete();
 }
@@ -81,29 +98,56 @@ SiteList::~SiteList() {
 
 Site* SiteList::Get(const std::string& siteID) {
     // Search for this id
-    for (int i = 0; i < (int)sites.size(); i++) {
-        if (sites[i]->GetID() == siteID) {
-            return sites[i];
-        }
+    std::unordered_map<std::string, Site*>::iterator it = siteIndex.find(siteID);
+    if (it != siteIndex.end()) {
+        return it->second;
     }
 
     // It's not there, so add it    
     if (siteID == "MATCHING") {
-        sites.push_back(new SpecialSite(siteID, siteRadius, renderer, lut, jobSpacing, siteSpacing, maxStackSize, showSpindles, mapExtents, unknownPos, offTheMapPos, labelHeight, labelFaceCamera, darkBackground));
+        sites.push_back(new SpecialSite(siteID, siteRadius, renderer, lut, jobSpacing, siteSpacing, maxStackSize, showSpindles, mapExtents, unknownPos, offTheMapPos, labels, labelFaceCamera, darkBackground, bars));
     }
     else if (siteID == "DONE") {
-        sites.push_back(new DoneSite(siteID, siteRadius, renderer, lut, jobSpacing, siteSpacing, maxStackSize, showSpindles, mapExtents, unknownPos, offTheMapPos, labelHeight, labelFaceCamera, darkBackground));
+        sites.push_back(new DoneSite(siteID, siteRadius, renderer, lut, jobSpacing, siteSpacing, maxStackSize, showSpindles, mapExtents, unknownPos, offTheMapPos, labels, labelFaceCamera, darkBackground, bars));
         doneSite = sites.back();
     }
     else {
-        sites.push_back(new Site(siteID, siteRadius, renderer, lut, jobSpacing, siteSpacing, maxStackSize, showSpindles, mapExtents, unknownPos, offTheMapPos, labelHeight, labelFaceCamera, darkBackground));
+        sites.push_back(new Site(siteID, siteRadius, renderer, lut, jobSpacing, siteSpacing, maxStackSize, showSpindles, mapExtents, unknownPos, offTheMapPos, labels, labelFaceCamera, darkBackground, bars));
     }
+    siteIndex[siteID] = sites.back();
+    sites.back()->ShowBars(showBars);
+
+    // Need to make room for the new site
+    converged = false;
 
     return sites.back();
 }
 
 
-void SiteList::Arrange() {
+bool SiteList::Arrange() {
+    // Check for sites that have moved or changed their stacks
+    bool moved = false;
+    for (int i = 0; i < (int)sites.size(); i++) {
+        if (sites[i]->GetLayoutChanged()) {
+            sites[i]->ClearLayoutChanged();
+            converged = false;
+            moved = true;
+        }
+    }
+
+    if (converged) return false;
+
+    // Repulsion falls off with the cube of the distance, so only stacks within a cutoff of 
+    // a few site spacings are used.  Bin all stacks in a uniform grid with cells the size
+    // of the cutoff, so only the neighboring cells need to be searched.
+    double cutoff = siteSpacing * repulsionCutoff;
+    if (cutoff <= 0.0) cutoff = 1.0;
+    double cutoff2 = cutoff * cutoff;
+
+    BinStacks(cutoff);
+
+    maxDisplacement = 0.0;
+
     // Loop over all sites
     for (int i = 0; i < (int)sites.size(); i++) {
         // Don't do for the matching and done sites
@@ -125,45 +169,43 @@ void SiteList::Arrange() {
         Vec2 locVec = loc - pos;
 
         // Do for all stacks at this site
-        double numStacks = sites[i]->GetNumStacks();
         for (int q = 0; q < sites[i]->GetNumStacks(); q++) {
             Vec2 stackPos(sites[i]->GetStackPosition(q).X(), sites[i]->GetStackPosition(q).Y());
 
-            // Loop over all sites
-            for (int j = 0; j < (int)sites.size(); j++) {
-                // Ignore this site
-                if (j == i) { 
-                    continue;
-                }
-
+            int cellX = (int)floor(stackPos.X() / cutoff);
+            int cellY = (int)floor(stackPos.Y() / cutoff);
 
-                // The force to be computed
-                Vec2 force;
+            // Loop over the neighboring cells
+            for (int x = cellX - 1; x <= cellX + 1; x++) {
+                for (int y = cellY - 1; y <= cellY + 1; y++) {
+                    std::unordered_map<long long, std::vector<int> >::iterator cell = grid.find(CellKey(x, y));
+                    if (cell == grid.end()) continue;
 
+                    const std::vector<int>& cellStacks = cell->second;
+                    for (int k = 0; k < (int)cellStacks.size(); k++) {
+                        const GridStack& stack = gridStacks[cellStacks[k]];
 
-                // Do for all stacks at the site
-                double numStacks2 = sites[j]->GetNumStacks();
-                for (int k = 0; k < sites[j]->GetNumStacks(); k++) {
-                    Vec2 pos2(sites[j]->GetStackPosition(k).X(), sites[j]->GetStackPosition(k).Y());
+                        // Ignore this site
+                        if (stack.site == i) {
+                            continue;
+                        }
 
-                    // Compute the force
-                    ComputeForce(force, stackPos, pos2);
-
-                    // Sum the vectors
-                    vec += force;
-                }
+                        // Ignore stacks past the cutoff
+                        Vec2 diff = stackPos - stack.position;
+                        if (diff.X() * diff.X() + diff.Y() * diff.Y() > cutoff2) {
+                            continue;
+                        }
 
+                        // The force to be computed
+                        Vec2 force;
 
-                // Now do for the location
-                // XXX : Removed for now, as the fact that these locations are fixed can lead 
-                //       to "jittering" of site positions
-//                Vec2 loc2 = sites[j]->GetLocation();
+                        // Compute the force
+                        ComputeForce(force, stackPos, stack.position);
 
-                // Compute the force
-//                ComputeForce(force, stackPos, loc2);
-
-                // Sum the vectors
-//                vec += force;
+                        // Sum the vectors
+                        vec += force;
+                    }
+                }
             }
         }
 
@@ -181,9 +223,21 @@ void SiteList::Arrange() {
         // Move a litte more smoothly
         vec *= 0.25;
 
+        double displacement = vec.Magnitude();
+        if (displacement > maxDisplacement) maxDisplacement = displacement;
+
+        // Don't bother repositioning the site, its stacks, and its jobs if it isn't moving
+        if (displacement < convergenceThreshold) continue;
+
         // Set the position
         sites[i]->SetPosition(Vec3(pos.X() + vec.X(), pos.Y() + vec.Y(), sites[i]->GetPosition().Z()));
+        moved = true;
     }
+
+    // Done until something changes
+    if (maxDisplacement < convergenceThreshold) converged = true;
+
+    return moved;
 }
 
 
@@ -215,6 +269,8 @@ void SiteList::SetJobSpacing(double spacing) {
 
 void SiteList::SetSiteSpacing(double spacing) {
     siteSpacing = spacing;
+
+    converged = false;
 }
 
 
@@ -272,7 +328,7 @@ void SiteList::ShowSiteRankingLegend(bool show) {
 
 
 void SiteList::SetLabelHeight(double height) {
-    labelHeight = height;
+    labels->SetLabelHeight(height);
 }
 
 void SiteList::LabelFaceCamera(bool faceCamera) {
@@ -293,6 +349,67 @@ void SiteList::Update() {
     }
 }
 
+bool SiteList::UpdateLabels() {
+    return labels->Update();
+}
+
+
+bool SiteList::GetShowBars() {
+    return showBars;
+}
+
+void SiteList::ShowBars(bool show) {
+    showBars = show;
+
+    for (int i = 0; i < (int)sites.size(); i++) {
+        sites[i]->ShowBars(showBars);
+    }
+}
+
+bool SiteList::UpdateBars() {
+    bool changed = false;
+    for (int i = 0; i < (int)sites.size(); i++) {
+        if (sites[i]->UpdateBars()) changed = true;
+    }
+
+    bars->Update();
+
+    return changed;
+}
+
+
+bool SiteList::GetConverged() {
+    return converged;
+}
+
+
+void SiteList::BinStacks(double cellSize) {
+    // Empty the cells, keeping their storage
+    for (std::unordered_map<long long, std::vector<int> >::iterator it = grid.begin(); it != grid.end(); it++) {
+        it->second.clear();
+    }
+    gridStacks.clear();
+
+    // Bin the stacks of all sites, including the matching and done sites
+    for (int i = 0; i < (int)sites.size(); i++) {
+        for (int k = 0; k < sites[i]->GetNumStacks(); k++) {
+            GridStack stack;
+            stack.position = Vec2(sites[i]->GetStackPosition(k).X(), sites[i]->GetStackPosition(k).Y());
+            stack.site = i;
+
+            int cellX = (int)floor(stack.position.X() / cellSize);
+            int cellY = (int)floor(stack.position.Y() / cellSize);
+
+            grid[CellKey(cellX, cellY)].push_back((int)gridStacks.size());
+            gridStacks.push_back(stack);
+        }
+    }
+}
+
+long long SiteList::CellKey(int x, int y) {
+    return ((long long)x << 32) | (unsigned int)y;
+}
+
 
 void SiteList::ComputeForce(Vec2& force, Vec2& pos, const Vec2& pos2) {
     // If coincident, give a random nudge
@@ -319,4 +436,7 @@ void SiteList::Reset() {
         delete sites[i];
     }
     sites.clear();
+    siteIndex.clear();
+
+    converged = false;
 }
\ No newline at end of file
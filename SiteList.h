@@ -13,11 +13,14 @@
 #define SITELIST_H
 
 
+#include "LabelLayer.h"
 #include "Site.h"
 
 #include <vtkColorTransferFunction.h>
 #include <vtkScalarBarActor.h>
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <Vec2.h>
@@ -29,7 +32,9 @@ public:
     ~SiteList();
 
     Site* Get(const std::string& siteID);
-    void Arrange();
+
+    // Move sites apart.  Returns true if any site moved.
+    bool Arrange();
 
     // Get/set spacing
     double GetJobSpacing();
@@ -65,6 +70,18 @@ public:
     // Force update
     void Update();
 
+    // Place the site labels for the current view.  Returns true if they changed.
+    bool UpdateLabels();
+
+    // Draw one bar per stack instead of the jobs, for distant views.  UpdateBars returns
+    // true if any bars changed.
+    bool GetShowBars();
+    void ShowBars(bool show);
+    bool UpdateBars();
+
+    // Whether the layout has settled, so Arrange has nothing to do
+    bool GetConverged();
+
     // Reset the data
     void Reset();
 
@@ -72,6 +89,9 @@ private:
     std::vector<Site*> sites;
     Site* doneSite;
 
+    // Sites by site ID
+    std::unordered_map<std::string, Site*> siteIndex;
+
     double siteRadius;
     double jobSpacing;
     double siteSpacing;
@@ -82,9 +102,34 @@ private:
 
     bool showSiteRankingLegend;
 
-    double labelHeight;
+    // Distance past which sites don't repel, as a multiple of the site spacing
+    double repulsionCutoff;
+
+    // The layout is converged when no site moves more than the threshold in an Arrange
+    bool converged;
+    double maxDisplacement;
+    double convergenceThreshold;
+
+    // Uniform grid of all stack positions, for finding nearby stacks quickly
+    struct GridStack {
+        Vec2 position;
+        int site;
+    };
+    std::vector<GridStack> gridStacks;
+    std::unordered_map<long long, std::vector<int> > grid;
+
+    void BinStacks(double cellSize);
+    long long CellKey(int x, int y);
+
     bool labelFaceCamera;
 
+    // Draws the names of all sites
+    LabelLayer* labels;
+
+    // Draws the bars of all sites
+    GlyphSet* bars;
+    bool showBars;
+
     double mapExtents[4];
     Vec2 unknownPos;
     Vec2 offTheMapPos;
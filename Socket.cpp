@@ -4,7 +4,8 @@
 //
 // Author:      David Borland
 //
-// Description: Implementation of Socket class for receiving data.
+// Description: Implementation of Socket class for receiving data using WinSock.  The
+//              POSIX implementation is in SocketPosix.cpp.
 //
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -12,9 +13,17 @@
 #include "Socket.h"
 
 #include <wx/log.h>
+#include <wx/utils.h>
 
 
+#ifdef _WIN32
+
 Socket::Socket(bool readAllData) : readAll(readAllData) {
+    sock = INVALID_SOCKET;
+
+    // Read in large chunks, reusing the same buffer
+    bufferSize = 65536;
+    buffer.resize(bufferSize);
 }
 
 
@@ -66,9 +75,6 @@ bool Socket::Init(const char* hostName, unsigned short port) {
 
 
 void Socket::Read(std::string& s) {
-    const int bufSize = 32;
-    char buffer[bufSize];
-
     unsigned long numBytes;
 
     // Initialize with whatever was leftover from last time
@@ -77,46 +83,60 @@ void Socket::Read(std::string& s) {
     // Read the data
     while (ioctlsocket(sock, FIONREAD, &numBytes) == 0 && numBytes > 0) {
         // Don't read more data than the buffer can handle
-        if (numBytes > bufSize - 1) numBytes = bufSize - 1;
-
-        // Clear the buffer
-        memset(buffer, 0, bufSize);
+        if (numBytes > bufferSize) numBytes = bufferSize;
 
         // Receive data
-        if (recv(sock, buffer, numBytes, 0) < 0) {
-            wxLogMessage("Error receiving data.", buffer);
+        int numReceived = recv(sock, &buffer[0], numBytes, 0);
+        if (numReceived < 0) {
+            wxLogMessage("Error receiving data.");
 
             // If in the middle of a line, discard everything
-            if (s[s.length() -1] != '\n') {
+            if (!s.empty() && s[s.length() - 1] != '\n') {
                 s.clear();
             }
             return;
         }
 
         // Append this buffer
-        s += buffer;
+        s.append(&buffer[0], numReceived);
 
         if (!readAll) break;
     }
 
+    KeepCompleteLines(s);
+}
+
+
+void Socket::Wait(int milliseconds) {
+    wxMilliSleep(milliseconds);
+}
+
+#endif
+
+
+void Socket::KeepCompleteLines(std::string& s) {
     // Only return completed lines
     std::string::size_type end = s.find_last_of("\n");
 
     if (end != std::string::npos) {
         // Save the remainder
-        remainder = s.substr(end + 1, s.length() - 1 - end);
+        remainder.assign(s, end + 1, std::string::npos);
 
         // Return the rest
-        s = s.substr(0, end + 1);
+        s.resize(end + 1);
     }
     else {
         // No complete lines
-        remainder = s;
+        remainder.swap(s);
         s.clear();
     }
 }
 
 
+void Socket::Resume() {
+}
+
+
 bool Socket::GetReadAll() {
     return readAll;
 }
@@ -4,7 +4,8 @@
 //
 // Author:      David Borland
 //
-// Description: Interface of Socket class for receiving data.
+// Description: Interface of Socket class for receiving data.  Uses WinSock on Windows and
+//              non-blocking sockets with epoll elsewhere.
 //
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -13,8 +14,14 @@
 #define SOCKET_H
 
 
+#ifdef _WIN32
 #include <winsock.h>
+#endif
+
+#include <atomic>
+#include <chrono>
 #include <string>
+#include <vector>
 
 
 class Socket {
@@ -25,15 +32,62 @@ public:
     virtual bool Init(const char* hostName, unsigned short port = 9001);
     virtual void Read(std::string& s);
 
+    // Wait up to the given number of milliseconds before the next read.  A connected POSIX
+    // socket returns as soon as there is data, otherwise this just sleeps.
+    virtual void Wait(int milliseconds);
+
+    // Called before the first read after a pause
+    virtual void Resume();
+
     bool GetReadAll();
     void SetReadAll(bool readAllData);
 
 protected:
     std::string remainder;
-    bool readAll;
+
+    // Set from the GUI thread and read from the socket thread
+    std::atomic<bool> readAll;
+
+    // Save any partial line at the end of s for the next read
+    void KeepCompleteLines(std::string& s);
 
 private:
+#ifdef _WIN32
     SOCKET sock;
+#else
+    enum ConnectState {
+        NotConnected,
+        Connecting,
+        Connected,
+        Failed
+    };
+
+    int sock;
+    int epollFd;
+    ConnectState connectState;
+
+    // Where to connect.  Looking up the host and connecting are put off until the first 
+    // Read, which is called from the socket thread, so they never block the GUI thread.
+    std::string host;
+    unsigned short port;
+
+    // Addresses found for the host, and the next one to try
+    struct addrinfo* addresses;
+    struct addrinfo* nextAddress;
+
+    // When the connection fails or closes, look up the host and connect again after a delay
+    double retrySeconds;
+    std::chrono::steady_clock::time_point retryTime;
+
+    bool Connect();
+    void Retry();
+    void CloseSocket();
+    void Close();
+#endif
+
+    // Buffer for receiving data
+    std::vector<char> buffer;
+    unsigned long bufferSize;
 };
 
 
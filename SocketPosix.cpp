@@ -0,0 +1,289 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        SocketPosix.cpp
+//
+// Author:      David Borland
+//
+// Description: Implementation of Socket class for receiving data on POSIX systems.  The
+//              socket is non-blocking, and epoll is used to wait for the connection to be
+//              made and for data to read.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _WIN32
+
+#include "Socket.h"
+
+#include <wx/log.h>
+#include <wx/utils.h>
+
+#include <errno.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+
+Socket::Socket(bool readAllData) : readAll(readAllData) {
+    sock = -1;
+    epollFd = -1;
+    connectState = NotConnected;
+    port = 0;
+
+    addresses = NULL;
+    nextAddress = NULL;
+
+    retrySeconds = 5.0;
+
+    // Read in large chunks, reusing the same buffer
+    bufferSize = 65536;
+    buffer.resize(bufferSize);
+}
+
+
+Socket::~Socket() {
+    Close();
+}
+
+
+bool Socket::Init(const char* hostName, unsigned short hostPort) {
+    Close();
+
+    // Just remember the host.  Connecting is done on the first Read.
+    host = hostName;
+    port = hostPort;
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        wxLogMessage("Can't create epoll instance.");
+        return false;
+    }
+
+    connectState = NotConnected;
+
+    return true;
+}
+
+
+void Socket::Read(std::string& s) {
+    // Initialize with whatever was leftover from last time
+    s = remainder;
+
+    if (connectState == Failed && std::chrono::steady_clock::now() >= retryTime) {
+        connectState = NotConnected;
+    }
+
+    if (connectState == NotConnected) Connect();
+
+    if (connectState == Failed || sock < 0) {
+        KeepCompleteLines(s);
+        return;
+    }
+
+    // Check if the socket is ready.  Wait has already done any waiting.
+    struct epoll_event event;
+    int numEvents = epoll_wait(epollFd, &event, 1, 0);
+
+    if (numEvents <= 0) {
+        KeepCompleteLines(s);
+        return;
+    }
+
+    if (connectState == Connecting) {
+        // Writable means the connection has finished, one way or the other
+        int error = 0;
+        socklen_t length = sizeof(error);
+        if (getsockopt(sock, SOL_SOCKET, SO_ERROR, &error, &length) < 0 || error != 0) {
+            wxLogMessage("Can't connect to socket.");
+
+            // Try the next address on the next read
+            CloseSocket();
+            if (nextAddress) connectState = NotConnected;
+            else Retry();
+
+            KeepCompleteLines(s);
+            return;
+        }
+
+        // Only wait for data from now on
+        struct epoll_event readEvent;
+        memset(&readEvent, 0, sizeof(readEvent));
+        readEvent.events = EPOLLIN;
+        readEvent.data.fd = sock;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, sock, &readEvent);
+
+        connectState = Connected;
+
+        KeepCompleteLines(s);
+        return;
+    }
+
+    // Read the data
+    while (true) {
+        ssize_t numReceived = recv(sock, &buffer[0], bufferSize, 0);
+
+        if (numReceived > 0) {
+            // Append this buffer
+            s.append(&buffer[0], numReceived);
+
+            if (!readAll) break;
+        }
+        else if (numReceived == 0) {
+            wxLogMessage("Connection closed.");
+
+            Retry();
+
+            // A partial line can't be finished by the next connection
+            KeepCompleteLines(s);
+            remainder.clear();
+            return;
+        }
+        else if (errno == EINTR) {
+            continue;
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            // Nothing more to read for now
+            break;
+        }
+        else {
+            wxLogMessage("Error receiving data.");
+
+            // If in the middle of a line, discard everything
+            if (!s.empty() && s[s.length() - 1] != '\n') {
+                s.clear();
+            }
+            return;
+        }
+    }
+
+    KeepCompleteLines(s);
+}
+
+
+void Socket::Wait(int milliseconds) {
+    if (connectState != Connecting && connectState != Connected) {
+        wxMilliSleep(milliseconds);
+        return;
+    }
+
+    // Block until the socket is ready or the time is up.  The event is left for Read, and
+    // returning early on a signal is harmless.
+    struct epoll_event event;
+    epoll_wait(epollFd, &event, 1, milliseconds);
+}
+
+
+bool Socket::Connect() {
+    // Find the server, unless there are addresses left to try.  This can block, but Read is
+    // only called from the socket thread.
+    if (!nextAddress) {
+        struct addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        char portString[16];
+        snprintf(portString, sizeof(portString), "%d", port);
+
+        if (addresses) freeaddrinfo(addresses);
+        addresses = NULL;
+
+        if (getaddrinfo(host.c_str(), portString, &hints, &addresses) != 0 || addresses == NULL) {
+            wxLogMessage("Can't find host.");
+
+            Retry();
+            return false;
+        }
+
+        nextAddress = addresses;
+    }
+
+    // Try each address until one connects or starts connecting
+    while (nextAddress) {
+        struct addrinfo* address = nextAddress;
+        nextAddress = nextAddress->ai_next;
+
+        // Set up the socket
+        sock = socket(address->ai_family, address->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, address->ai_protocol);
+        if (sock < 0) continue;
+
+        // Start connecting to the server, without waiting
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.data.fd = sock;
+
+        if (connect(sock, address->ai_addr, address->ai_addrlen) == 0) {
+            connectState = Connected;
+            event.events = EPOLLIN;
+        }
+        else if (errno == EINPROGRESS) {
+            connectState = Connecting;
+            event.events = EPOLLOUT;
+        }
+        else {
+            CloseSocket();
+            continue;
+        }
+
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, sock, &event) < 0) {
+            wxLogMessage("Can't wait on socket.");
+
+            Retry();
+            return false;
+        }
+
+        return true;
+    }
+
+    wxLogMessage("Can't connect to host.");
+
+    Retry();
+    return false;
+}
+
+
+void Socket::Retry() {
+    CloseSocket();
+
+    // Look up the host again next time
+    nextAddress = NULL;
+
+    connectState = Failed;
+    retryTime = std::chrono::steady_clock::now() + 
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(retrySeconds));
+}
+
+
+void Socket::CloseSocket() {
+    if (sock >= 0) {
+        // Stop waiting on the socket
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, sock, NULL);
+
+        close(sock);
+        sock = -1;
+    }
+}
+
+
+void Socket::Close() {
+    CloseSocket();
+
+    if (addresses) {
+        freeaddrinfo(addresses);
+        addresses = NULL;
+    }
+    nextAddress = NULL;
+
+    if (epollFd >= 0) {
+        close(epollFd);
+        epollFd = -1;
+    }
+
+    connectState = NotConnected;
+}
+
+#endif
\ No newline at end of file
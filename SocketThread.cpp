@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        SocketThread.cpp
+//
+// Author:      David Borland
+//
+// Description: Implementation of SocketThread class for MatchMaker.  Reads the socket on its
+//              own thread, converts lines of text to binary event records, and pushes them
+//              onto a queue that is drained by the graphics thread, so network I/O and
+//              tokenizing never run on the render thread.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "SocketThread.h"
+
+#include <wx/log.h>
+
+
+SocketThread::SocketThread(Socket* readSocket, EventQueue<std::string>* dataQueue, int readInterval, bool binaryData)
+: wxThread(wxTHREAD_JOINABLE), socket(readSocket), queue(dataQueue), interval(readInterval), paused(false), stop(false),
+  binary(binaryData) {
+}
+
+
+SocketThread::~SocketThread() {
+}
+
+
+int SocketThread::GetReadInterval() {
+    return interval;
+}
+
+void SocketThread::SetReadInterval(int readInterval) {
+    interval = readInterval < 1 ? 1 : readInterval;
+}
+
+
+void SocketThread::SetPaused(bool pause) {
+    paused = pause;
+}
+
+
+void SocketThread::Stop() {
+    stop = true;
+
+    Wait();
+}
+
+
+wxThread::ExitCode SocketThread::Entry() {
+    std::string s;
+    std::string events;
+    bool wasPaused = false;
+
+    while (!stop) {
+        if (paused) {
+            wasPaused = true;
+        }
+        else {
+            // Let the socket know time has passed without reading
+            if (wasPaused) {
+                socket->Resume();
+                wasPaused = false;
+            }
+
+            // Only read more if the last events made it onto the queue, and lines after an EOF
+            // have been converted
+            if (events.empty()) {
+                if (s.empty()) socket->Read(s);
+
+                if (binary) {
+                    events.swap(s);
+                    s.clear();
+                }
+                else if (!s.empty()) {
+                    ConvertLines(s, events);
+                }
+            }
+
+            // If the queue is full, hang on to the events and try again next time
+            if (!events.empty() && queue->Push(events)) {
+                // Push swapped in a recycled buffer
+                events.clear();
+            }
+        }
+
+        // Wait on the socket, which returns early when there is data.  When paused or when
+        // events are still waiting for room on the queue, the socket would be ready right
+        // away, so just sleep.  Lines left after an EOF are converted right away.
+        if (paused || !events.empty()) {
+            Sleep(interval);
+        }
+        else if (s.empty()) {
+            socket->Wait(interval);
+        }
+    }
+
+    return 0;
+}
+
+
+void SocketThread::ConvertLines(std::string& lines, std::string& events) {
+    // A live socket sends new job IDs forever, so start the string table again now and then.
+    // Strings are written again before they are next used.
+    if (writer.GetNumStrings() > 100000) writer.ClearStrings();
+
+    Tokenizer tokens(lines);
+    while (tokens.NextLine()) {
+        int numTokens = tokens.GetNumTokens();
+
+        // Ignore pings and local IDs
+        if (numTokens == 1 && tokens[0] == "ping") continue;
+        if (numTokens == 4 && tokens[2] == "localid") continue;
+
+        if (!writer.WriteLine(tokens, events)) {
+            std::string line;
+            tokens.GetLine().CopyTo(line);
+            wxLogMessage("Invalid event: %s", line.c_str());
+        }
+        else if (numTokens == 1 && tokens[0] == "EOF") {
+            // The parser stops at the EOF, and the strings start again after it, so the rest
+            // of the lines go in the next chunk
+            const Token& line = tokens.GetLine();
+            lines.erase(0, line.start + line.length - lines.data());
+            return;
+        }
+    }
+
+    lines.clear();
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        SocketThread.h
+//
+// Author:      David Borland
+//
+// Description: Interface of SocketThread class for MatchMaker.  Reads the socket on its own
+//              thread, converts lines of text to binary event records, and pushes them onto
+//              a queue that is drained by the graphics thread, so network I/O and
+//              tokenizing never run on the render thread.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef SOCKETTHREAD_H
+#define SOCKETTHREAD_H
+
+
+#include <wx/thread.h>
+
+#include <atomic>
+#include <string>
+
+#include "BinaryEvent.h"
+#include "EventQueue.h"
+#include "Socket.h"
+
+
+class SocketThread : public wxThread {
+public:
+    // Text data is converted to binary event records before it is queued.  Binary data is
+    // queued as is.
+    SocketThread(Socket* readSocket, EventQueue<std::string>* dataQueue, int readInterval, bool binaryData);
+    virtual ~SocketThread();
+
+    // Longest time to wait between reads, in milliseconds
+    int GetReadInterval();
+    void SetReadInterval(int readInterval);
+
+    void SetPaused(bool pause);
+
+    // Ask the thread to finish and wait for it
+    void Stop();
+
+protected:
+    virtual ExitCode Entry();
+
+private:
+    // The socket and queue are owned by the Engine
+    Socket* socket;
+    EventQueue<std::string>* queue;
+
+    std::atomic<int> interval;
+    std::atomic<bool> paused;
+    std::atomic<bool> stop;
+
+    // Converts text data.  Only used on the thread.
+    bool binary;
+    BinaryEventWriter writer;
+
+    // Converts lines up to and including the first EOF, and removes them from lines
+    void ConvertLines(std::string& lines, std::string& events);
+};
+
+
+#endif
\ No newline at end of file
@@ -12,51 +12,39 @@
 
 #include "Stack.h"
 
-#include <vtkPolyDataMapper.h>
 #include <vtkProperty.h>
 
+#include "GeometryCache.h"
 
-Stack::Stack(double innerRadius, double outerRadius, double spindleRadius, double resolution, bool showSiteSpindle, vtkRenderer* ren) : renderer(ren) {
+
+Stack::Stack(double innerRadius, double outerRadius, double spindleRadius, double resolution, bool showSiteSpindle, vtkRenderer* ren,
+             GlyphSet* barGlyphs) : renderer(ren), bars(barGlyphs) {
     spindleOffset = 0.02;
+    showBar = false;
+    diskResolution = (int)resolution;
 
     // Create the disk
-    disk = vtkDiskSource::New();
-    disk->SetRadialResolution(1);
-    disk->SetCircumferentialResolution(resolution);
-    disk->SetInnerRadius(innerRadius);
-    disk->SetOuterRadius(outerRadius);
-    vtkPolyDataMapper* diskMapper = vtkPolyDataMapper::New();
-    diskMapper->SetInputConnection(disk->GetOutputPort());
     diskActor = vtkActor::New();
-    diskActor->SetMapper(diskMapper);
     diskActor->GetProperty()->SetAmbient(1.0);
     diskActor->GetProperty()->SetDiffuse(0.0);
     diskActor->GetProperty()->SetSpecular(0.0);
+    SetDiskRadii(innerRadius, outerRadius);
 
 
     // Create a spindle representing the maximum number of jobs so far
-    spindle = vtkCylinderSource::New();
-    spindle->SetResolution(resolution);
-    spindle->SetHeight(0.0);
-    spindle->SetRadius(spindleRadius);
-    vtkPolyDataMapper* spindleMapper = vtkPolyDataMapper::New();
-    spindleMapper->SetInputConnection(spindle->GetOutputPort());
     spindleActor = vtkActor::New();
-    spindleActor->SetMapper(spindleMapper);
+    spindleActor->SetMapper(GeometryCache::GetMapper(GeometryCache::Cylinder, diskResolution));
     spindleActor->GetProperty()->SetAmbient(0.0);
     spindleActor->GetProperty()->SetDiffuse(1.0);
     spindleActor->GetProperty()->SetSpecular(0.0);
-    spindleActor->RotateX(90.0);
+    this->spindleRadius = spindleRadius;
+    spindleHeight = 0.0;
+    SetSpindleScale();
 
 
     // Add to the renderer
     renderer->AddViewProp(diskActor);
     if (showSiteSpindle) renderer->AddViewProp(spindleActor);
-
-
-    // Don't need these reference any more
-    diskMapper->Delete();
-    spindleMapper->Delete();
 }
 
 
@@ -66,10 +54,12 @@ Stack::~Stack() {
     if (spindleActor) renderer->RemoveViewProp(spindleActor);
 
     // Clean up
-    if (disk) disk->Delete();
     if (diskActor) diskActor->Delete();
-    if (spindle) spindle->Delete();
     if (spindleActor) spindleActor->Delete();
+
+    for (int i = 0; i < (int)barRows.size(); i++) {
+        bars->RemoveRow(barRows[i]);
+    }
 }
 
 
@@ -80,9 +70,10 @@ void Stack::SetPosition(const Vec3& pos) {
 
 
 void Stack::SetRadii(double innerRadius, double outerRadius, double spindleRadius) {
-    disk->SetInnerRadius(innerRadius);
-    disk->SetOuterRadius(outerRadius);
-    spindle->SetRadius(spindleRadius);
+    SetDiskRadii(innerRadius, outerRadius);
+
+    this->spindleRadius = spindleRadius;
+    SetSpindleScale();
 }
 
 
@@ -93,7 +84,8 @@ void Stack::SetColor(double r, double g, double b) {
 
 
 void Stack::SetSpindleHeight(double height) {
-    spindle->SetHeight(height);
+    spindleHeight = height;
+    SetSpindleScale();
     SetSpindlePosition();
 }
 
@@ -111,8 +103,51 @@ Vec3 Stack::GetPosition() {
 }
 
 
+void Stack::ShowBar(bool show) {
+    showBar = show;
+
+    // Segments are shown again when next set
+    if (!showBar) {
+        for (int i = 0; i < (int)barRows.size(); i++) {
+            bars->SetVisible(barRows[i], false);
+        }
+    }
+}
+
+
+void Stack::SetBarSegment(int segment, double bottom, double height, double radius, const double* color) {
+    while ((int)barRows.size() <= segment) {
+        barRows.push_back(bars->AddRow());
+    }
+
+    int row = barRows[segment];
+
+    bars->SetVisible(row, showBar && height > 0.0);
+    if (!showBar || height <= 0.0) return;
+
+    const double* pos = diskActor->GetPosition();
+    bars->SetPosition(row, pos[0], pos[1], bottom + height * 0.5);
+    bars->SetScale(row, radius, radius, height);
+    bars->SetColor(row, color[0], color[1], color[2]);
+}
+
+
 void Stack::SetSpindlePosition() {
     spindleActor->SetPosition(diskActor->GetPosition()[0],
                               diskActor->GetPosition()[1],
-                              diskActor->GetPosition()[2] + spindleOffset + spindle->GetHeight() * 0.5);
+                              diskActor->GetPosition()[2] + spindleOffset + spindleHeight * 0.5);
+}
+
+
+void Stack::SetDiskRadii(double innerRadius, double outerRadius) {
+    // The shared disk has an outer radius of 1, so the inner radius is a fraction of that
+    double inner = outerRadius > 0.0 ? innerRadius / outerRadius : 0.0;
+
+    diskActor->SetMapper(GeometryCache::GetMapper(GeometryCache::Disk, diskResolution, inner));
+    diskActor->SetScale(outerRadius, outerRadius, 1.0);
+}
+
+
+void Stack::SetSpindleScale() {
+    spindleActor->SetScale(spindleRadius, spindleRadius, spindleHeight);
 }
\ No newline at end of file
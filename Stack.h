@@ -15,16 +15,18 @@
 
 
 #include <vtkActor.h>
-#include <vtkCylinderSource.h>
-#include <vtkDiskSource.h>
 #include <vtkRenderer.h>
 
+#include <vector>
+
+#include "GlyphSet.h"
 #include "Vec3.h"
 
 
 class Stack {
 public:
-    Stack(double innerRadius, double outerRadius, double spindleRadius, double resolution, bool showSiteSpindle, vtkRenderer* ren);
+    Stack(double innerRadius, double outerRadius, double spindleRadius, double resolution, bool showSiteSpindle, vtkRenderer* ren,
+          GlyphSet* barGlyphs);
     virtual ~Stack();
 
     virtual void SetPosition(const Vec3& pos);
@@ -35,16 +37,30 @@ public:
 
     Vec3 GetPosition();
 
+    // An aggregate bar drawn in place of the jobs when zoomed out.  Each segment is a row in
+    // the shared bar glyph set, stacked from the bottom of the stack.
+    void ShowBar(bool show);
+    void SetBarSegment(int segment, double bottom, double height, double radius, const double* color);
+
 protected:
-    vtkDiskSource* disk;
+    // The disk and spindle use shared unit geometry, scaled by their actors
     vtkActor* diskActor;
-    vtkCylinderSource* spindle;
     vtkActor* spindleActor;
 
     vtkRenderer* renderer;
 
+    int diskResolution;
+    double spindleRadius;
+    double spindleHeight;
     double spindleOffset;
 
+    GlyphSet* bars;
+    std::vector<int> barRows;
+    bool showBar;
+
+    void SetDiskRadii(double innerRadius, double outerRadius);
+    void SetSpindleScale();
+
     virtual void SetSpindlePosition();
 };
 
@@ -5,55 +5,346 @@
 // Author:      David Borland
 //
 // Description: Implemenation of TextFileSocket class for reading data from a text file
-//              as if it were a socket. 
+//              as if it were a socket.  Snapshots of the replay state are kept while reading,
+//              so seeking only has to apply the lines after the nearest snapshot.
 //
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
 
 #include "TextFileSocket.h"
 
+#include "Tokenizer.h"
+
 #include <wx/log.h>
 
 
-TextFileSocket::TextFileSocket(bool readAllData) : Socket(readAllData) {
+TextFileSocket::TextFileSocket(bool readAllData, int numLinesPerRead, double speed, int numSnapshotLines) 
+: Socket(readAllData), replaySpeed(speed) {
+    currentLine = 0;
+    SetLinesPerRead(numLinesPerRead);
+    readAllLines = 65536;
+
+    replayTime = 0.0;
+    replayStarted = false;
+    lastReadTime = std::chrono::steady_clock::now();
+
+    hasTimeRange = false;
+    startTime = 0.0;
+    endTime = 0.0;
+
+    startSnapshotLines = numSnapshotLines < 0 ? 0 : numSnapshotLines;
+    snapshotLines = startSnapshotLines;
+
+    // Even, so the last snapshot is kept when thinning
+    maxSnapshots = 64;
 }
 
 
 TextFileSocket::~TextFileSocket() {
-    file.close();
+    file.Close();
 }
 
 
 bool TextFileSocket::Init(const char* hostName, unsigned short ignore) {
-    file.open(hostName, std::fstream::in);
-    if (file.fail()) {
+    if (!Open(hostName)) {
         wxLogMessage("Couldn't open %s", hostName);
         return false;
     }
 
+    currentLine = 0;
+    replayStarted = false;
+
+    // Start with an empty state
+    replayState.Reset();
+    snapshots.clear();
+    snapshotLines = startSnapshotLines;
+    if (snapshotLines > 0) snapshots.push_back(replayState);
+
+    // Look for timestamps near the start and end of the file
+    int numLines = GetNumLines();
+    int maxSearch = 1000;
+
+    hasTimeRange = false;
+    for (int i = 0; i < numLines && i < maxSearch; i++) {
+        if (GetTimestamp(i, startTime)) {
+            hasTimeRange = true;
+            break;
+        }
+    }
+    if (hasTimeRange) {
+        hasTimeRange = false;
+        for (int i = numLines - 1; i >= 0 && i >= numLines - maxSearch; i--) {
+            if (GetTimestamp(i, endTime)) {
+                hasTimeRange = endTime > startTime;
+                break;
+            }
+        }
+    }
+
     return true;
 }
 
 
 void TextFileSocket::Read(std::string& s) {
+    if (!file.IsOpen()) {
+        s.clear();
+        return;
+    }
+
+    // Advance the replay clock by the wall-clock time since the last read
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - lastReadTime).count();
+    lastReadTime = now;
+
     // Check if the previous line read was the last line
-    if (file.eof()) {
-        s = "EOF";
+    if (currentLine >= GetNumLines()) {
+        EndOfFile(s);
 
-        file.clear();
-        file.seekg(0, std::fstream::beg);
+        currentLine = 0;
+        replayStarted = false;
+        replayState.Reset();
 
         return;
     }
 
-    // Read the data
+    int lastLine = GetNumLines();
+
+    double speed = replaySpeed;
+    double timestamp;
+    if (speed > 0.0 && GetTimestamp(currentLine, timestamp)) {
+        // Release every line up to the current replay time.  Lines without a timestamp go 
+        // out with the line before them.
+        if (!replayStarted) {
+            replayTime = timestamp;
+            replayStarted = true;
+        }
+        else {
+            replayTime += elapsed * speed;
+        }
+
+        for (int i = currentLine; i < lastLine; i++) {
+            if (GetTimestamp(i, timestamp) && timestamp > replayTime) {
+                lastLine = i;
+                break;
+            }
+        }
+
+        // Nothing due yet
+        if (lastLine == currentLine) {
+            s.clear();
+            return;
+        }
+    }
+    else {
+        // No timestamp, so use a fixed number of lines per read
+        int numLines = readAll ? readAllLines : linesPerRead;
+        if (currentLine + numLines < lastLine) lastLine = currentLine + numLines;
+    }
+
+    CopyLines(currentLine, lastLine, s);
+
+    // Keep the replay state up to date for snapshots
+    if (snapshotLines > 0) FoldTo(lastLine);
+
+    currentLine = lastLine;
+}
+
+
+void TextFileSocket::Resume() {
+    // Don't count the time spent paused
+    lastReadTime = std::chrono::steady_clock::now();
+}
+
+void TextFileSocket::Wait(int milliseconds) {
+    // Go straight on to the next lines, unless they are released by timestamp.  The file
+    // starts again at line 0 after the end, so wait then.
+    double timestamp;
+    if (readAll && file.IsOpen() && currentLine > 0 && currentLine < GetNumLines() &&
+        !(replaySpeed > 0.0 && GetTimestamp(currentLine, timestamp))) {
+        return;
+    }
+
+    Socket::Wait(milliseconds);
+}
+
+
+int TextFileSocket::GetLinesPerRead() {
+    return linesPerRead;
+}
+
+void TextFileSocket::SetLinesPerRead(int numLines) {
+    linesPerRead = numLines < 1 ? 1 : numLines;
+}
+
+
+double TextFileSocket::GetReplaySpeed() {
+    return replaySpeed;
+}
+
+void TextFileSocket::SetReplaySpeed(double speed) {
+    replaySpeed = speed < 0.0 ? 0.0 : speed;
+}
+
+
+bool TextFileSocket::Open(const char* fileName) {
+    // Map the file and index the lines up front
+    return file.Open(fileName);
+}
+
+
+void TextFileSocket::Seek(double position, std::string& s) {
     s.clear();
-    while (!file.eof()) {
-        std::string buff;
-        getline(file, buff);
 
-        s += buff + "\n";
+    if (!file.IsOpen()) return;
 
-        if (!readAll) break;
+    position = position < 0.0 ? 0.0 : position > 1.0 ? 1.0 : position;
+
+    int line;
+    if (hasTimeRange) {
+        line = FindLine(startTime + position * (endTime - startTime));
+    }
+    else {
+        line = (int)(position * GetNumLines());
+    }
+
+    if (snapshotLines > 0) {
+        // Start from the nearest snapshot before the line, unless the current line is closer
+        int snapshot = line / snapshotLines;
+        if (snapshot >= (int)snapshots.size()) snapshot = (int)snapshots.size() - 1;
+
+        if (currentLine > line || currentLine < snapshot * snapshotLines) {
+            replayState = snapshots[snapshot];
+            currentLine = snapshot * snapshotLines;
+        }
+    }
+    else {
+        // Start from the beginning
+        replayState.Reset();
+        currentLine = 0;
     }
+
+    // Apply the rest of the lines
+    FoldTo(line);
+
+    WriteState(currentLine, s);
+
+    // Restart the replay clock from here
+    replayStarted = false;
+}
+
+
+bool TextFileSocket::GetTimeRange(double& start, double& end) {
+    start = startTime;
+    end = endTime;
+
+    return hasTimeRange;
+}
+
+
+void TextFileSocket::FoldTo(int line) {
+    while (currentLine < line) {
+        // Stop at the next snapshot
+        int next = line;
+        if (snapshotLines > 0) {
+            int snapshotLine = (currentLine / snapshotLines + 1) * snapshotLines;
+            if (snapshotLine < next) next = snapshotLine;
+        }
+
+        FoldLines(currentLine, next);
+        currentLine = next;
+
+        if (snapshotLines > 0 && currentLine == (int)snapshots.size() * snapshotLines) {
+            replayState.Prune();
+            snapshots.push_back(replayState);
+
+            if ((int)snapshots.size() > maxSnapshots) ThinSnapshots();
+        }
+    }
+}
+
+
+void TextFileSocket::ThinSnapshots() {
+    // Keep the even snapshots, which are at multiples of the new spacing
+    int numKept = 0;
+    for (int i = 0; i < (int)snapshots.size(); i += 2) {
+        if (numKept != i) snapshots[numKept].Swap(snapshots[i]);
+        numKept++;
+    }
+
+    snapshots.resize(numKept);
+    snapshotLines *= 2;
+}
+
+
+int TextFileSocket::FindLine(double time) {
+    int numLines = GetNumLines();
+
+    // Binary search, using the next line with a timestamp for lines without one
+    int low = 0;
+    int high = numLines;
+
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+
+        int line = middle;
+        double timestamp;
+        while (line < high && !GetTimestamp(line, timestamp)) line++;
+
+        if (line < high && timestamp < time) {
+            low = line + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+
+int TextFileSocket::GetNumLines() {
+    return file.GetNumLines();
+}
+
+
+void TextFileSocket::CopyLines(int first, int last, std::string& s) {
+    // Copy them in one go.  The string's buffer is recycled through the queue, 
+    // so this doesn't normally allocate.
+    size_t length;
+    const char* lines = file.GetLines(first, last, length);
+    s.assign(lines, length);
+
+    // The last line might not have a newline
+    if (s.empty() || s[s.length() - 1] != '\n') s += '\n';
+}
+
+
+bool TextFileSocket::GetTimestamp(int line, double& timestamp) {
+    size_t length;
+    const char* data = file.GetLines(line, line + 1, length);
+
+    Tokenizer tokens(data, (int)length);
+    if (!tokens.NextLine() || !tokens.HasTimestamp()) return false;
+
+    timestamp = tokens.GetTimestamp();
+
+    return true;
+}
+
+
+void TextFileSocket::EndOfFile(std::string& s) {
+    s = "EOF";
+}
+
+
+void TextFileSocket::FoldLines(int first, int last) {
+    size_t length;
+    const char* lines = file.GetLines(first, last, length);
+
+    replayState.ParseLines(lines, (int)length);
+}
+
+
+void TextFileSocket::WriteState(int line, std::string& s) {
+    replayState.Write(s);
 }
\ No newline at end of file
@@ -5,7 +5,11 @@
 // Author:      David Borland
 //
 // Description: Interface of TextFileSocket class for reading data from a text file
-//              as if it were a socket.
+//              as if it were a socket.  The file is memory mapped, and lines are copied
+//              straight from the mapped file.  Lines that start with a timestamp are
+//              released in time with the recording, scaled by the replay speed.  Snapshots
+//              of the replay state are kept while reading, so seeking only has to apply
+//              the lines after the nearest snapshot.
 //
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -14,21 +18,107 @@
 #define TEXTFILESOCKET_H
 
 
+#include "MappedFile.h"
+#include "ReplayState.h"
 #include "Socket.h"
 
-#include <fstream>
+#include <atomic>
+#include <chrono>
+#include <vector>
 
 
 class TextFileSocket : public Socket {
 public:
-    TextFileSocket(bool readAllData = false);
+    TextFileSocket(bool readAllData = false, int numLinesPerRead = 1, double speed = 1.0, int numSnapshotLines = 10000);
     virtual ~TextFileSocket();
 
     virtual bool Init(const char* fileName, unsigned short ignore = 0);
     virtual void Read(std::string& s);
+    virtual void Resume();
+
+    // When reading all, the rest of the file is ready, so only wait at the end
+    virtual void Wait(int milliseconds);
+
+    // Number of lines returned by each read, unless reading all
+    int GetLinesPerRead();
+    void SetLinesPerRead(int numLines);
+
+    // Multiple of real time to replay timestamped lines at.  0 ignores timestamps.
+    double GetReplaySpeed();
+    void SetReplaySpeed(double speed);
+
+    // Move to a position in the file, from 0 to 1, by time if the file has timestamps and by
+    // line otherwise.  Fills s with data that recreates the model at that position, to be 
+    // parsed after resetting the model.  Not thread safe, so stop reading first.
+    void Seek(double position, std::string& s);
+
+    // Times of the first and last timestamps, if the file has them
+    bool GetTimeRange(double& start, double& end);
+
+protected:
+    MappedFile file;
+
+    // Map and index the file
+    virtual bool Open(const char* fileName);
+
+    // Files are read a line at a time.  Subclasses can read other units of data by 
+    // overriding these.
+    virtual int GetNumLines();
+    virtual void CopyLines(int first, int last, std::string& s);
+
+    // Get the timestamp of a line, if it has one
+    virtual bool GetTimestamp(int line, double& timestamp);
+
+    // Data to send at the end of the file
+    virtual void EndOfFile(std::string& s);
+
+    // State of everything read so far
+    ReplayState replayState;
+
+    // Apply lines to the replay state
+    virtual void FoldLines(int first, int last);
+
+    // Write the replay state as data to send.  Line is the next line to be read.
+    virtual void WriteState(int line, std::string& s);
 
 private:
-    std::fstream file;
+    // The next line to read
+    int currentLine;
+
+    int linesPerRead;
+
+    // Lines returned by each read when reading all, so no read copies the whole file
+    int readAllLines;
+
+    // Set from the GUI thread, and read on the socket thread
+    std::atomic<double> replaySpeed;
+
+    // Time in the recording that has been replayed up to, in seconds
+    double replayTime;
+    bool replayStarted;
+
+    // Wall-clock time of the last read
+    std::chrono::steady_clock::time_point lastReadTime;
+
+    // Times of the first and last timestamps
+    bool hasTimeRange;
+    double startTime;
+    double endTime;
+
+    // Snapshot i is the replay state before line i * snapshotLines.  0 means no snapshots.
+    // When there are too many, every other one is dropped and the spacing doubles.
+    int startSnapshotLines;
+    int snapshotLines;
+    int maxSnapshots;
+    std::vector<ReplayState> snapshots;
+
+    void ThinSnapshots();
+
+    // Apply lines up to line to the replay state, taking snapshots along the way
+    void FoldTo(int line);
+
+    // Find the first line at or after the given time
+    int FindLine(double time);
 
     bool loop;
 };
@@ -0,0 +1,213 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        Tokenizer.cpp
+//
+// Author:      David Borland
+//
+// Description: Implementation of Tokenizer class for MatchMaker.  Splits data read from the
+//              socket into lines and tokens without copying.  Tokens point into the original
+//              buffer, which must stay unchanged while they are in use.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Tokenizer.h"
+
+#include <string.h>
+
+
+Token::Token() : start(NULL), length(0) {
+}
+
+
+bool Token::operator==(const char* s) const {
+    // Compare without calling strlen, so mismatches usually stop at the first character
+    for (int i = 0; i < length; i++) {
+        if (s[i] != start[i]) return false;
+    }
+
+    return s[length] == '\0';
+}
+
+bool Token::operator!=(const char* s) const {
+    return !(*this == s);
+}
+
+bool Token::operator==(const Token& t) const {
+    return length == t.length && memcmp(start, t.start, length) == 0;
+}
+
+bool Token::operator!=(const Token& t) const {
+    return !(*this == t);
+}
+
+
+void Token::CopyTo(std::string& s) const {
+    s.assign(start, length);
+}
+
+
+double Token::ToDouble() const {
+    const char* c = start;
+    const char* tokenEnd = start + length;
+
+    // Sign
+    bool negative = false;
+    if (c < tokenEnd && (*c == '-' || *c == '+')) {
+        negative = *c == '-';
+        c++;
+    }
+
+    // Integer part
+    double value = 0.0;
+    bool digits = false;
+    while (c < tokenEnd && *c >= '0' && *c <= '9') {
+        value = value * 10.0 + (*c - '0');
+        digits = true;
+        c++;
+    }
+
+    // Fractional part
+    if (c < tokenEnd && *c == '.') {
+        c++;
+
+        double scale = 0.1;
+        while (c < tokenEnd && *c >= '0' && *c <= '9') {
+            value += (*c - '0') * scale;
+            scale *= 0.1;
+            digits = true;
+            c++;
+        }
+    }
+
+    if (!digits) return 0.0;
+
+    // Exponent
+    if (c < tokenEnd && (*c == 'e' || *c == 'E')) {
+        c++;
+
+        bool negativeExponent = false;
+        if (c < tokenEnd && (*c == '-' || *c == '+')) {
+            negativeExponent = *c == '-';
+            c++;
+        }
+
+        int exponent = 0;
+        while (c < tokenEnd && *c >= '0' && *c <= '9') {
+            exponent = exponent * 10 + (*c - '0');
+            c++;
+        }
+
+        double power = 1.0;
+        for (int i = 0; i < exponent && i < 400; i++) {
+            power *= 10.0;
+        }
+
+        if (negativeExponent) value /= power;
+        else value *= power;
+    }
+
+    return negative ? -value : value;
+}
+
+
+Tokenizer::Tokenizer(const char* data, int length) 
+: current(data), end(data + length), numTokens(0), tooManyTokens(false), hasTimestamp(false) {
+}
+
+Tokenizer::Tokenizer(const std::string& data) 
+: current(data.data()), end(data.data() + data.size()), numTokens(0), tooManyTokens(false), hasTimestamp(false) {
+}
+
+
+bool Tokenizer::NextLine() {
+    while (current < end) {
+        // Find the end of the line
+        const char* lineEnd = (const char*)memchr(current, '\n', end - current);
+        if (!lineEnd) lineEnd = end;
+
+        line.start = current;
+        line.length = lineEnd - current;
+
+        // Strip a carriage return
+        if (line.length > 0 && line.start[line.length - 1] == '\r') line.length--;
+
+        current = lineEnd < end ? lineEnd + 1 : end;
+
+        TokenizeLine();
+
+        // Skip blank lines
+        if (numTokens > 0) return true;
+    }
+
+    numTokens = 0;
+    tooManyTokens = false;
+    hasTimestamp = false;
+
+    return false;
+}
+
+
+const Token& Tokenizer::GetLine() const {
+    return line;
+}
+
+
+int Tokenizer::GetNumTokens() const {
+    return numTokens;
+}
+
+bool Tokenizer::TooManyTokens() const {
+    return tooManyTokens;
+}
+
+const Token& Tokenizer::operator[](int i) const {
+    return tokens[i];
+}
+
+
+bool Tokenizer::HasTimestamp() const {
+    return hasTimestamp;
+}
+
+double Tokenizer::GetTimestamp() const {
+    return hasTimestamp ? timestamp.ToDouble() : 0.0;
+}
+
+
+void Tokenizer::TokenizeLine() {
+    numTokens = 0;
+    tooManyTokens = false;
+    hasTimestamp = false;
+
+    const char* c = line.start;
+    const char* lineEnd = line.start + line.length;
+
+    while (c < lineEnd) {
+        // Skip delimiters
+        while (c < lineEnd && (*c == ' ' || *c == '\t')) c++;
+
+        if (c >= lineEnd) break;
+
+        // Find the end of the token
+        const char* tokenStart = c;
+        while (c < lineEnd && *c != ' ' && *c != '\t') c++;
+
+        // Leading timestamp
+        if (numTokens == 0 && !hasTimestamp && *tokenStart == '@') {
+            timestamp.start = tokenStart + 1;
+            timestamp.length = c - tokenStart - 1;
+            hasTimestamp = true;
+            continue;
+        }
+
+        if (numTokens == MaxTokens) {
+            tooManyTokens = true;
+            break;
+        }
+
+        tokens[numTokens].start = tokenStart;
+        tokens[numTokens].length = c - tokenStart;
+        numTokens++;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        Tokenizer.h
+//
+// Author:      David Borland
+//
+// Description: Interface of Tokenizer class for MatchMaker.  Splits data read from the socket
+//              into lines and tokens without copying.  Tokens point into the original buffer,
+//              which must stay unchanged while they are in use.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+
+#include <string>
+
+
+// A view of part of a buffer
+class Token {
+public:
+    Token();
+
+    bool operator==(const char* s) const;
+    bool operator!=(const char* s) const;
+    bool operator==(const Token& t) const;
+    bool operator!=(const Token& t) const;
+
+    // Copy into a string, reusing its storage
+    void CopyTo(std::string& s) const;
+
+    // Parse the token as a number in place.  Returns 0.0 if it isn't a number, like atof.
+    double ToDouble() const;
+
+    const char* start;
+    int length;
+};
+
+
+class Tokenizer {
+public:
+    // No protocol line has more tokens than this
+    enum { MaxTokens = 10 };
+
+    Tokenizer(const char* data, int length);
+    Tokenizer(const std::string& data);
+
+    // Move to the next non-empty line.  Returns false when there are no more lines.
+    bool NextLine();
+
+    // The current line, without the line ending
+    const Token& GetLine() const;
+
+    // Tokens in the current line.  Any tokens past MaxTokens are dropped.
+    int GetNumTokens() const;
+    bool TooManyTokens() const;
+    const Token& operator[](int i) const;
+
+    // Lines in recorded data files can start with a timestamp in seconds, written as @seconds.
+    // It is not counted as one of the line's tokens.
+    bool HasTimestamp() const;
+    double GetTimestamp() const;
+
+private:
+    const char* current;
+    const char* end;
+
+    Token line;
+
+    Token tokens[MaxTokens];
+    int numTokens;
+    bool tooManyTokens;
+
+    Token timestamp;
+    bool hasTimestamp;
+
+    void TokenizeLine();
+};
+
+
+#endif
\ No newline at end of file
@@ -78,6 +78,8 @@ void KeyPressCallback::Execute(vtkObject* caller, unsigned long eventId, void* c
             else if (c == 'w') {
                 engine->ChangeWorkflow();
             }
+
+            engine->RequestRender();
         }
     }
 }
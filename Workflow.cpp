@@ -49,6 +49,10 @@ void Workflow::SetUsername(const std::string& workflowUsername) {
 
 
 void Workflow::InsertJob(Job* job) {
+    // A job is only in one workflow, once
+    if (job->GetWorkflow()) job->GetWorkflow()->RemoveJob(job);
+
+    job->SetWorkflow(this, (int)jobs.size());
     jobs.push_back(job);
 
     if (faded) {
@@ -97,27 +101,65 @@ void Workflow::ShowLabels(bool show) {
 std::vector<std::string> Workflow::RemoveDuplicates(Job *job) {
     std::vector<std::string> jobIDs;
 
-    // First pass to see if in this workflow
-    bool here = false;
+    if (job->GetWorkflow() != this) return jobIDs;
+
+    // The job is in this workflow, find duplicates
     for (int i = 0; i < (int)jobs.size(); i++) {
-        if (jobs[i]->GetID() == job->GetID()) {
-            here = true;
-            break;
+        if (jobs[i] != job && jobs[i]->GetName() == job->GetName()) {
+            jobIDs.push_back(jobs[i]->GetID());
+
+            // The last job moves into this slot, so check it again
+            RemoveJob(jobs[i]);
+            i--;
         }
     }
 
-    if (!here) return jobIDs;
+    // Retired duplicates
+    typedef std::unordered_multimap<std::string, std::string>::iterator RetiredIterator;
+    std::pair<RetiredIterator, RetiredIterator> range = retiredIDs.equal_range(job->GetName());
+    for (RetiredIterator it = range.first; it != range.second; it++) {
+        if (it->second != job->GetID()) jobIDs.push_back(it->second);
+    }
+    retiredIDs.erase(range.first, range.second);
 
-    // The job is in this workflow, find duplicates
-    for (int i = 0; i < (int)jobs.size(); i++) {
-        if (jobs[i]->GetID() != job->GetID()) {
-            if (jobs[i]->GetName() == job->GetName()) {
-                jobIDs.push_back(jobs[i]->GetID());
-                jobs.erase(jobs.begin() + i);
-                i--;
-            }
+    return jobIDs;
+}
+
+
+bool Workflow::RetireJob(Job* job) {
+    if (job->GetWorkflow() != this) return false;
+
+    RemoveJob(job);
+
+    if (job->GetName().size() > 0) {
+        retiredIDs.insert(std::make_pair(job->GetName(), job->GetID()));
+    }
+
+    return true;
+}
+
+
+void Workflow::ForgetRetiredJob(const std::string& jobName, const std::string& jobID) {
+    typedef std::unordered_multimap<std::string, std::string>::iterator RetiredIterator;
+    std::pair<RetiredIterator, RetiredIterator> range = retiredIDs.equal_range(jobName);
+    for (RetiredIterator it = range.first; it != range.second; it++) {
+        if (it->second == jobID) {
+            retiredIDs.erase(it);
+            return;
         }
     }
+}
 
-    return jobIDs;
+
+void Workflow::RemoveJob(Job* job) {
+    int slot = job->GetWorkflowSlot();
+
+    // Move the last job into this slot
+    if (slot != (int)jobs.size() - 1) {
+        jobs[slot] = jobs.back();
+        jobs[slot]->SetWorkflow(this, slot);
+    }
+    jobs.pop_back();
+
+    job->SetWorkflow(NULL, -1);
 }
\ No newline at end of file
@@ -15,6 +15,7 @@
 
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "Job.h"
@@ -44,19 +45,32 @@ public:
 
     std::vector<std::string> RemoveDuplicates(Job* job);
 
+    // Drop a finished job that is being deleted, keeping its name for finding duplicates.
+    // Returns false if the job isn't in this workflow.
+    bool RetireJob(Job* job);
+
+    // Stop looking for duplicates of a retired job
+    void ForgetRetiredJob(const std::string& jobName, const std::string& jobID);
+
 private:
     std::string id;
     std::string name;
     std::string username;
 
     // The jobs in this workflow.  These are pointers to Jobs in the Engine's Job vector.
-    // They are neither created nor destroyed here.
+    // They are neither created nor destroyed here.  Each job knows its slot, so it can be
+    // removed by swapping the last job into its place.
     std::vector<Job*> jobs;
 
+    // IDs of retired jobs with names, by name
+    std::unordered_multimap<std::string, std::string> retiredIDs;
+
     bool faded;
     double fadedOpacity;
 
     bool showLabels;
+
+    void RemoveJob(Job* job);
 };
 
 
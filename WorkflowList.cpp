@@ -124,12 +124,18 @@ void WorkflowList::SetDefaultLabel(const std::string& defaultWorkflowLabel) {
 
 
 std::vector<std::string> WorkflowList::RemoveDuplicates(Job* job) {
-    std::vector<std::string> jobIDs;
-    for (int i = 0; i < (int)workflows.size(); i++) {
-        jobIDs = workflows[i]->RemoveDuplicates(job);
-        if (jobIDs.size() > 0) break;
-    }
-    return jobIDs;
+    // Only the job's own workflow can have duplicates
+    Workflow* workflow = job->GetWorkflow();
+    if (!workflow) return std::vector<std::string>();
+
+    return workflow->RemoveDuplicates(job);
+}
+
+
+bool WorkflowList::RetireJob(Job* job) {
+    Workflow* workflow = job->GetWorkflow();
+
+    return workflow && workflow->RetireJob(job) && job->GetName().size() > 0;
 }
 
 
@@ -42,6 +42,10 @@ public:
 
     std::vector<std::string> RemoveDuplicates(Job* job);
 
+    // Drop a finished job that is being deleted from its workflow.  Returns true if its ID
+    // was kept for finding duplicates.
+    bool RetireJob(Job* job);
+
     // Reset the data
     void Reset();
 
@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        vtkMyLabelRenderStrategy.cxx
+//
+// Author:      David Borland
+//
+// Description: Draw each label in the color picked by its key.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "vtkMyLabelRenderStrategy.h"
+
+#include <vtkObjectFactory.h>
+#include <vtkTextProperty.h>
+#include <vtkUnicodeString.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+vtkCxxRevisionMacro(vtkMyLabelRenderStrategy, "$Revision: 1.0 $");
+vtkStandardNewMacro(vtkMyLabelRenderStrategy);
+
+// Separates the text from the key, which follows it
+static const char KeySeparator = '\x1f';
+
+// Keys without a color
+static const unsigned int NoColor = 0xFFFFFFFF;
+
+//----------------------------------------------------------------------------
+vtkMyLabelRenderStrategy::vtkMyLabelRenderStrategy()
+{
+  this->ColorProperty = vtkTextProperty::New();
+}
+
+//----------------------------------------------------------------------------
+vtkMyLabelRenderStrategy::~vtkMyLabelRenderStrategy()
+{
+  this->ColorProperty->Delete();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMyLabelRenderStrategy::GetKeyedLabel(const std::string& text, int key)
+{
+  char s[16];
+  sprintf(s, "%c%d", KeySeparator, key);
+
+  return text + s;
+}
+
+//----------------------------------------------------------------------------
+void vtkMyLabelRenderStrategy::SetLabelColor(int key, unsigned int color)
+{
+  if (key >= (int)this->LabelColors.size())
+    {
+    this->LabelColors.resize(key + 1, NoColor);
+    }
+
+  this->LabelColors[key] = color;
+}
+
+//----------------------------------------------------------------------------
+void vtkMyLabelRenderStrategy::ComputeLabelBounds(vtkTextProperty* tprop, vtkStdString label, double bds[4])
+{
+  std::string text;
+  this->SplitLabel(label, text);
+
+  this->Superclass::ComputeLabelBounds(tprop, vtkStdString(text), bds);
+}
+
+//----------------------------------------------------------------------------
+void vtkMyLabelRenderStrategy::ComputeLabelBounds(vtkTextProperty* tprop, vtkUnicodeString label, double bds[4])
+{
+  std::string text;
+  this->SplitLabel(label.utf8_str(), text);
+
+  this->Superclass::ComputeLabelBounds(tprop, vtkUnicodeString::from_utf8(text), bds);
+}
+
+//----------------------------------------------------------------------------
+void vtkMyLabelRenderStrategy::RenderLabel(int x[2], vtkTextProperty* tprop, vtkStdString label)
+{
+  std::string text;
+  int key = this->SplitLabel(label, text);
+
+  this->Superclass::RenderLabel(x, this->GetLabelProperty(tprop, key), vtkStdString(text));
+}
+
+//----------------------------------------------------------------------------
+void vtkMyLabelRenderStrategy::RenderLabel(int x[2], vtkTextProperty* tprop, vtkUnicodeString label)
+{
+  std::string text;
+  int key = this->SplitLabel(label.utf8_str(), text);
+
+  this->Superclass::RenderLabel(x, this->GetLabelProperty(tprop, key), vtkUnicodeString::from_utf8(text));
+}
+
+//----------------------------------------------------------------------------
+int vtkMyLabelRenderStrategy::SplitLabel(const std::string& label, std::string& text)
+{
+  std::string::size_type separator = label.rfind(KeySeparator);
+  if (separator == std::string::npos)
+    {
+    text = label;
+    return -1;
+    }
+
+  text.assign(label, 0, separator);
+
+  return atoi(label.c_str() + separator + 1);
+}
+
+//----------------------------------------------------------------------------
+vtkTextProperty* vtkMyLabelRenderStrategy::GetLabelProperty(vtkTextProperty* tprop, int key)
+{
+  if (key < 0 || key >= (int)this->LabelColors.size() || this->LabelColors[key] == NoColor)
+    {
+    return tprop;
+    }
+
+  unsigned int color = this->LabelColors[key];
+
+  this->ColorProperty->ShallowCopy(tprop);
+  this->ColorProperty->SetColor(((color >> 16) & 0xFF) / 255.0, ((color >> 8) & 0xFF) / 255.0, (color & 0xFF) / 255.0);
+
+  return this->ColorProperty;
+}
\ No newline at end of file
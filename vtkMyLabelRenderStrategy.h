@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Name:        vtkMyLabelRenderStrategy.h
+//
+// Author:      David Borland
+//
+// Description: Draw each label in its own color, so labels of every color can share one
+//              label hierarchy and placement mapper.  The color is picked by a key at the
+//              end of the label, which is not drawn, so labels with the same text can have
+//              different colors.
+//
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __vtkMyLabelRenderStrategy_h
+#define __vtkMyLabelRenderStrategy_h
+
+#include "vtkFreeTypeLabelRenderStrategy.h"
+
+#include <string>
+#include <vector>
+
+class vtkTextProperty;
+
+class VTK_RENDERING_EXPORT vtkMyLabelRenderStrategy : public vtkFreeTypeLabelRenderStrategy
+{
+public:
+  static vtkMyLabelRenderStrategy *New();
+  vtkTypeRevisionMacro(vtkMyLabelRenderStrategy,vtkFreeTypeLabelRenderStrategy);
+
+  // Label with a key, which picks its color
+  static std::string GetKeyedLabel(const std::string& text, int key);
+
+  // Color of labels with the given key, as packed RGB.  Labels without a color use the color
+  // of the text property they are rendered with.
+  void SetLabelColor(int key, unsigned int color);
+
+  virtual void ComputeLabelBounds(vtkTextProperty* tprop, vtkStdString label, double bds[4]);
+  virtual void ComputeLabelBounds(vtkTextProperty* tprop, vtkUnicodeString label, double bds[4]);
+
+  virtual void RenderLabel(int x[2], vtkTextProperty* tprop, vtkStdString label);
+  virtual void RenderLabel(int x[2], vtkTextProperty* tprop, vtkUnicodeString label);
+
+protected:
+  vtkMyLabelRenderStrategy();
+  ~vtkMyLabelRenderStrategy();
+
+  // Packed RGB for each key
+  std::vector<unsigned int> LabelColors;
+
+  // Copy of the text property with the label's color
+  vtkTextProperty* ColorProperty;
+
+  // Split a keyed label into its text and key.  Returns -1 if it has no key.
+  static int SplitLabel(const std::string& label, std::string& text);
+
+  vtkTextProperty* GetLabelProperty(vtkTextProperty* tprop, int key);
+
+private:
+  vtkMyLabelRenderStrategy(const vtkMyLabelRenderStrategy&);  // Not implemented.
+  void operator=(const vtkMyLabelRenderStrategy&);  // Not implemented.
+};
+
+#endif
\ No newline at end of file